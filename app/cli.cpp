@@ -0,0 +1,542 @@
+#include "cli.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/alloc_tracking.h"
+#include "core/perf_counters.h"
+#include "core/profiler.h"
+#include "core/replication.h"
+#include "core/report_io.h"
+
+namespace {
+
+bool parse_double(const std::string &valeur, double &out) {
+  try {
+    size_t idx = 0;
+    out = std::stod(valeur, &idx);
+    return idx == valeur.size();
+  } catch (...) {
+    return false;
+  }
+}
+
+bool parse_int(const std::string &valeur, int &out) {
+  try {
+    size_t idx = 0;
+    const long parsed = std::stol(valeur, &idx);
+    if (idx != valeur.size() || parsed < 0)
+      return false;
+    out = static_cast<int>(parsed);
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+SchedulingPolicy parse_policy(const std::string &value) {
+  if (value == "fifo")
+    return SchedulingPolicy::Fifo;
+  if (value == "priority" || value == "priorite")
+    return SchedulingPolicy::PriorityFirst;
+  if (value == "balanced" || value == "equilibre")
+    return SchedulingPolicy::Balanced;
+  throw std::invalid_argument("Politique inconnue: " + value);
+}
+
+std::string rendre_rapport(const SimulationConfig &config,
+                           const SimulationReport &report) {
+  std::ostringstream os;
+  os << "\n--- Synthese simulation ---\n";
+  os << "Politique : " << scheduling_policy_to_string(config.policy)
+     << " | Salles : " << config.operating_rooms
+     << " | Lits reveil : " << config.recovery_beds << '\n';
+  os << "Horizon : " << config.horizon_hours << " h"
+     << " | Programmes : " << config.elective_patients
+     << " | Urgences (lambda) : " << config.urgent_rate_per_hour << "/h\n";
+  os << "Arrives : " << report.patients_arrived
+     << " (urgences : " << report.urgent_arrived
+     << ", programmes : " << report.elective_arrived << ")\n";
+  os << "Operes : " << report.patients_operated
+     << " | Termines (apres reveil) : " << report.patients_completed
+     << " | En attente bloc : " << report.pending_waiting << '\n';
+  os << "Attente moyenne avant bloc : " << report.average_wait_to_surgery
+     << " min (max " << report.max_wait_to_surgery << ")\n";
+  os << "Attente moyenne vers reveil : " << report.average_wait_to_recovery
+     << " min\n";
+  os << "Temps moyen dans le systeme : " << report.average_total_time_in_system
+     << " min\n";
+  os << "Utilisation blocs : " << report.operating_room_utilization * 100.0
+     << "% | Utilisation reveil : " << report.recovery_bed_utilization * 100.0
+     << "%\n";
+  os << "Debit : " << report.throughput_per_hour << " patients/heure\n";
+  return os.str();
+}
+
+std::string rendre_compteurs(const EngineStats &stats) {
+  std::ostringstream os;
+  os << "\n--- Compteurs du moteur ---\n";
+  for (std::size_t t = 0; t < EngineStats::kEventTypes; ++t) {
+    const std::uint64_t n = stats.events[t];
+    os << event_type_name(static_cast<EventType>(t)) << " : " << n
+       << " evenements, "
+       << (n ? static_cast<double>(stats.handler_nanoseconds[t]) / n : 0.0)
+       << " ns/evenement\n";
+  }
+  os << "pick_next_patient : " << stats.picks << " appels, "
+     << (stats.picks
+             ? static_cast<double>(stats.pick_nanoseconds) / stats.picks
+             : 0.0)
+     << " ns/appel\n";
+  os << "File d'evenements : max " << stats.max_event_queue << ", moyenne "
+     << stats.mean_event_queue << '\n';
+  os << "Attente bloc max : " << stats.max_waiting_surgery
+     << " | Attente reveil max : " << stats.max_waiting_recovery << '\n';
+  return os.str();
+}
+
+std::string rendre_memoire(const AllocationStats &stats) {
+  std::ostringstream os;
+  os << "\n--- Memoire ---\n";
+  os << "Allocations : " << stats.allocations << " ("
+     << stats.deallocations << " liberations) | Octets alloues : "
+     << stats.bytes << '\n';
+  os << "Pic de memoire vive : " << stats.peak_live_bytes / 1024.0
+     << " Kio\n";
+  return os.str();
+}
+
+std::string rendre_agregat(const SimulationConfig &config,
+                           const ReplicationSummary &summary) {
+  std::ostringstream os;
+  os << "\n--- Synthese de " << summary.replications()
+     << " replications (graine " << config.seed << ") ---\n";
+  os << "Politique : " << scheduling_policy_to_string(config.policy)
+     << " | Salles : " << config.operating_rooms
+     << " | Lits reveil : " << config.recovery_beds << '\n';
+  const auto &defs = report_metrics();
+  for (size_t i = 0; i < defs.size(); ++i) {
+    const RunningStat &stat = summary.metrics[i];
+    os << defs[i].name << " : " << stat.mean << " +/- "
+       << stat.ci95_half_width() << " (IC 95 %, min " << stat.min << ", max "
+       << stat.max << ")\n";
+  }
+  return os.str();
+}
+
+int lancer_balayage(const SimulationConfig &config, const OptionsLot &lot,
+                    bool alloc_stats, std::size_t memory_budget) {
+  SweepDefinition definition;
+  definition.base = config;
+  definition.memory_budget = memory_budget;
+  definition.track_memory = alloc_stats;
+  definition.axes = lot.axes;
+  definition.mode = lot.sweep_mode;
+  if (lot.replications > 0)
+    definition.replications = lot.replications;
+  const OutputFormat format = parse_output_format(
+      lot.format == "text" ? std::string("csv") : lot.format);
+  SweepRunner runner(definition, lot.threads);
+
+  std::vector<std::string> champs;
+  for (const SweepAxis &axis : definition.axes)
+    champs.push_back(axis.field);
+
+  const std::string empreinte = runner.definition().fingerprint();
+  if (lot.output.empty()) {
+    SweepWriter writer(std::cout, format, champs, true, empreinte);
+    runner.run(writer);
+    return 0;
+  }
+  std::vector<size_t> faits;
+  if (lot.resume)
+    faits = recover_sweep_output(lot.output, format, empreinte);
+  const bool en_tete = !lot.resume || !std::filesystem::exists(lot.output) ||
+                       std::filesystem::file_size(lot.output) == 0;
+  std::ofstream out(lot.output, lot.resume ? std::ios::app : std::ios::trunc);
+  if (!out)
+    throw std::runtime_error("Impossible d'ouvrir " + lot.output);
+  SweepWriter writer(out, format, champs, en_tete, empreinte);
+  const size_t calcules = runner.run(writer, faits);
+  std::cerr << calcules << " points calcules, " << faits.size()
+            << " repris sur " << definition.point_count() << '\n';
+  return 0;
+}
+
+// Run chauffe puis run mesure (memoire deja reservee) ; le nombre
+// d'evenements vient d'un run identique avec compteurs du moteur.
+int lancer_perf(const SimulationConfig &config) {
+  PerfProfiler perf;
+  if (!perf.available()) {
+    std::cerr << "Erreur : compteurs materiels indisponibles (" << perf.error()
+              << ")\n";
+    return 1;
+  }
+  SimulationConfig comptage = config;
+  comptage.collect_stats = true;
+  const std::uint64_t evenements =
+      Simulation(comptage).run().engine.total_events();
+
+  Simulation simulation(config);
+  simulation.run();
+  simulation.reset(config);
+  perf.clear();
+  simulation.set_profiler(&perf);
+  const SimulationReport report = simulation.run();
+  std::cout << rendre_rapport(config, report);
+
+  std::cout << "\n--- Compteurs materiels (" << evenements
+            << " evenements) ---\n";
+  const double par =
+      static_cast<double>(std::max<std::uint64_t>(1, evenements));
+  for (std::size_t p = 0; p < kEnginePhases; ++p) {
+    const EnginePhase phase = static_cast<EnginePhase>(p);
+    const PhaseCounters &c = perf.phase(phase);
+    std::cout << PerfProfiler::phase_name(phase) << " : "
+              << static_cast<double>(c.nanoseconds) / 1e3 << " us";
+    for (std::size_t k = 0; k < kHardwareCounters; ++k) {
+      const HardwareCounter compteur = static_cast<HardwareCounter>(k);
+      if (!perf.counter_available(compteur))
+        continue;
+      std::cout << " | " << PerfProfiler::counter_name(compteur) << " "
+                << c.values[k] << " (" << c.values[k] / par << "/evt)";
+    }
+    const std::uint64_t cycles = c.values[0];
+    if (cycles > 0 && perf.counter_available(HardwareCounter::Instructions)) {
+      std::cout << " | IPC " << static_cast<double>(c.values[1]) /
+                                    static_cast<double>(cycles);
+    }
+    std::cout << '\n';
+  }
+  return 0;
+}
+
+int lancer_lot(const SimulationConfig &config, const OptionsLot &lot,
+               bool alloc_stats, std::size_t memory_budget) {
+  const int replications = std::max(1, lot.replications);
+  ReplicationRunner runner(config, lot.threads);
+  runner.set_memory_budget(memory_budget);
+  const ReplicationSummary summary = runner.run(replications);
+
+  std::ofstream fichier;
+  if (!lot.output.empty()) {
+    fichier.open(lot.output);
+    if (!fichier)
+      throw std::runtime_error("Impossible d'ouvrir " + lot.output);
+  }
+  std::ostream &out = lot.output.empty() ? std::cout : fichier;
+
+  if (lot.format == "text") {
+    out << rendre_agregat(config, summary);
+    if (config.collect_stats) {
+      EngineStats total;
+      for (const SimulationReport &run : runner.reports())
+        total.merge(run.engine);
+      out << rendre_compteurs(total);
+    }
+    if (alloc_stats) {
+      AllocationStats total;
+      for (const AllocationStats &run : runner.allocations())
+        total.merge(run);
+      out << rendre_memoire(total);
+    }
+    return 0;
+  }
+  BatchWriter writer(out, parse_output_format(lot.format), config.seed);
+  for (int r = 0; r < replications; ++r) {
+    writer.write_run(r, runner.reports()[r],
+                     alloc_stats ? &runner.allocations()[r] : nullptr);
+  }
+  writer.write_summary(summary);
+  return 0;
+}
+
+// Run unique : les allocations comptees sont celles du moteur (construction
+// et run), trace Chrome comprise.
+int lancer_run(const LigneCommande &ligne) {
+  std::ofstream fichier_trace;
+  std::unique_ptr<ChromeTraceWriter> profileur;
+  if (!ligne.chrome_trace.empty()) {
+    fichier_trace.open(ligne.chrome_trace);
+    if (!fichier_trace) {
+      std::cerr << "Erreur : impossible d'ouvrir " << ligne.chrome_trace
+                << "\n";
+      return 1;
+    }
+    profileur = std::make_unique<ChromeTraceWriter>(fichier_trace);
+  }
+  SimulationReport report;
+  AllocationStats memoire;
+  {
+    AllocationScope portee(ligne.memory_budget);
+    Simulation simulation(ligne.config);
+    simulation.set_profiler(profileur.get());
+    report = simulation.run();
+    memoire = portee.stats();
+  }
+  if (profileur)
+    profileur->finish();
+  std::cout << rendre_rapport(ligne.config, report);
+  if (ligne.config.collect_stats)
+    std::cout << rendre_compteurs(report.engine);
+  if (ligne.alloc_stats)
+    std::cout << rendre_memoire(memoire);
+  return 0;
+}
+
+} // namespace
+
+void afficher_aide(const char *nom) {
+  std::cout
+      << "Usage : " << nom << " [options]\n"
+      << "Options CLI (resume texte) :\n"
+      << "  --horizon <heures>            Duree de simulation (defaut 8)\n"
+      << "  --ors <nb>                    Nombre de salles d'operation (defaut "
+         "2)\n"
+      << "  --recovery-beds <nb>          Nombre de lits de reveil (defaut 3)\n"
+      << "  --elective-count <nb>         Nombre de patients programmes "
+         "(defaut 10)\n"
+      << "  --elective-window <heures>    Fenetre d'arrivee des programmes "
+         "(defaut 6)\n"
+      << "  --urgent-rate <par_heure>     Frequence des urgences "
+         "(patients/heure, defaut 2)\n"
+      << "  --mean-surgery-elective <m>   Duree moy. chirurgie programmee "
+         "(minutes)\n"
+      << "  --mean-surgery-urgent <m>     Duree moy. chirurgie urgente "
+         "(minutes)\n"
+      << "  --mean-recovery <m>           Duree moy. de reveil (minutes)\n"
+      << "  --policy <fifo|priority|priorite|balanced|equilibre> Politique "
+         "d'ordonnancement (defaut priority)\n"
+      << "  --trace                       Affiche la trace des evenements\n"
+      << "  --seed <n>                    Graine aleatoire (defaut 1337)\n"
+      << "  --stats                       Compteurs du moteur (evenements, "
+         "files, temps)\n"
+      << "  --chrome-trace <fichier>      Trace Chrome/Perfetto du run (calcul "
+         "et ressources)\n"
+      << "  --perf                        Compteurs materiels par phase et par "
+         "evenement (Linux)\n"
+      << "  --alloc-stats                 Allocations et pic memoire par run\n"
+      << "  --memory-budget <Mo>          Budget memoire par run ; arret "
+         "(code 3) si depasse\n"
+      << "Lots et balayages (sans interface) :\n"
+      << "  --replications <n>            Replications independantes "
+         "(defaut 1, 10 en balayage)\n"
+      << "  --threads <n>                 Threads de calcul (defaut : tous "
+         "les coeurs)\n"
+      << "  --format <text|csv|jsonl>     Format de sortie (defaut text, csv "
+         "en balayage)\n"
+      << "  --output <fichier>            Ecrit la sortie dans un fichier\n"
+      << "  --sweep <champ=a:b:pas|champ=v1,v2,...>  Axe de balayage "
+         "(repetable)\n"
+      << "  --sweep-mode <grid|list>      Produit cartesien ou liste (defaut "
+         "grid)\n"
+      << "  --resume                      Reprend un balayage interrompu "
+         "(--output)\n"
+      << "  --gui                         Lance l'interface graphique "
+         "(AppMed)\n"
+      << "  --help                        Affiche cette aide\n";
+}
+
+LigneCommande analyser_arguments(const std::vector<std::string> &args) {
+  LigneCommande ligne;
+  for (size_t i = 0; i < args.size(); ++i) {
+    const std::string &arg = args[i];
+    auto besoin_valeur = [&](const std::string &flag) -> std::string {
+      if (i + 1 >= args.size()) {
+        throw std::invalid_argument("Valeur manquante pour " + flag);
+      }
+      return args[++i];
+    };
+
+    if (arg == "--help") {
+      ligne.aide = true;
+    } else if (arg == "--gui") {
+      ligne.gui = true;
+    } else if (arg == "--horizon") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Horizon invalide");
+      }
+      ligne.config.horizon_hours = value;
+    } else if (arg == "--ors") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value)) {
+        throw std::invalid_argument("Nombre de salles invalide");
+      }
+      ligne.config.operating_rooms = value;
+    } else if (arg == "--recovery-beds") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value)) {
+        throw std::invalid_argument("Nombre de lits invalide");
+      }
+      ligne.config.recovery_beds = value;
+    } else if (arg == "--elective-count") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value)) {
+        throw std::invalid_argument("Nombre de programmes invalide");
+      }
+      ligne.config.elective_patients = value;
+    } else if (arg == "--elective-window") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Fenetre programmes invalide");
+      }
+      ligne.config.elective_window_hours = value;
+    } else if (arg == "--urgent-rate") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Taux urgence invalide");
+      }
+      ligne.config.urgent_rate_per_hour = value;
+    } else if (arg == "--mean-surgery-elective") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Duree chirurgie programmee invalide");
+      }
+      ligne.config.mean_surgery_minutes_elective = value;
+    } else if (arg == "--mean-surgery-urgent") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Duree chirurgie urgente invalide");
+      }
+      ligne.config.mean_surgery_minutes_urgent = value;
+    } else if (arg == "--mean-recovery") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value)) {
+        throw std::invalid_argument("Duree reveil invalide");
+      }
+      ligne.config.mean_recovery_minutes = value;
+    } else if (arg == "--policy") {
+      const std::string raw = besoin_valeur(arg);
+      ligne.config.policy = parse_policy(raw);
+    } else if (arg == "--trace") {
+      ligne.config.trace_events = true;
+    } else if (arg == "--stats") {
+      ligne.config.collect_stats = true;
+    } else if (arg == "--perf") {
+      ligne.perf = true;
+    } else if (arg == "--alloc-stats") {
+      ligne.alloc_stats = true;
+    } else if (arg == "--memory-budget") {
+      double value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_double(raw, value) || value <= 0.0) {
+        throw std::invalid_argument("Budget memoire invalide");
+      }
+      ligne.memory_budget =
+          static_cast<std::size_t>(value * 1024.0 * 1024.0);
+    } else if (arg == "--chrome-trace") {
+      ligne.chrome_trace = besoin_valeur(arg);
+    } else if (arg == "--seed") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value)) {
+        throw std::invalid_argument("Graine invalide");
+      }
+      ligne.config.seed = static_cast<unsigned int>(value);
+    } else if (arg == "--replications") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value) || value <= 0) {
+        throw std::invalid_argument("Nombre de replications invalide");
+      }
+      ligne.lot.replications = value;
+    } else if (arg == "--threads") {
+      int value;
+      const std::string raw = besoin_valeur(arg);
+      if (!parse_int(raw, value)) {
+        throw std::invalid_argument("Nombre de threads invalide");
+      }
+      ligne.lot.threads = value;
+    } else if (arg == "--format") {
+      ligne.lot.format = besoin_valeur(arg);
+      if (ligne.lot.format != "text")
+        parse_output_format(ligne.lot.format);
+    } else if (arg == "--output") {
+      ligne.lot.output = besoin_valeur(arg);
+    } else if (arg == "--sweep") {
+      ligne.lot.axes.push_back(SweepAxis::parse(besoin_valeur(arg)));
+    } else if (arg == "--sweep-mode") {
+      const std::string raw = besoin_valeur(arg);
+      if (raw == "grid") {
+        ligne.lot.sweep_mode = SweepMode::Grid;
+      } else if (raw == "list") {
+        ligne.lot.sweep_mode = SweepMode::List;
+      } else {
+        throw std::invalid_argument("Mode de balayage inconnu : " + raw);
+      }
+    } else if (arg == "--resume") {
+      ligne.lot.resume = true;
+    } else {
+      throw std::invalid_argument("Option inconnue : " + arg);
+    }
+  }
+
+  return ligne;
+}
+
+int executer_sans_interface(const LigneCommande &ligne) {
+  const OptionsLot &lot = ligne.lot;
+  try {
+    if (lot.resume && (lot.axes.empty() || lot.output.empty())) {
+      throw std::invalid_argument("--resume demande --sweep et --output");
+    }
+    const bool lot_demande = lot.replications > 1 || lot.format != "text" ||
+                             !lot.output.empty();
+    if ((!ligne.chrome_trace.empty() || ligne.perf) &&
+        (lot_demande || !lot.axes.empty())) {
+      throw std::invalid_argument(
+          "--chrome-trace et --perf portent sur un run unique");
+    }
+    if (ligne.perf && !ligne.chrome_trace.empty()) {
+      throw std::invalid_argument("--perf et --chrome-trace sont exclusifs");
+    }
+    // --stats ferait mesurer la boucle instrumentee, pas celle d'un run
+    if (ligne.perf && ligne.config.collect_stats) {
+      throw std::invalid_argument("--perf et --stats sont exclusifs");
+    }
+    if ((ligne.alloc_stats || ligne.memory_budget > 0) &&
+        !allocation_tracking_available()) {
+      throw std::invalid_argument("--alloc-stats et --memory-budget demandent "
+                                  "-DAPPMED_ALLOC_HOOKS=ON");
+    }
+    // Portee budgetee : code moteur seul (le flux de la trace avalerait
+    // l'exception du budget)
+    if (ligne.memory_budget > 0 && !ligne.chrome_trace.empty()) {
+      throw std::invalid_argument(
+          "--memory-budget et --chrome-trace sont exclusifs");
+    }
+    if (ligne.perf)
+      return lancer_perf(ligne.config);
+    if (!lot.axes.empty()) {
+      return lancer_balayage(ligne.config, lot, ligne.alloc_stats,
+                             ligne.memory_budget);
+    }
+    if (lot_demande) {
+      return lancer_lot(ligne.config, lot, ligne.alloc_stats,
+                        ligne.memory_budget);
+    }
+    return lancer_run(ligne);
+  } catch (const MemoryBudgetExceeded &ex) {
+    std::cerr << "Erreur : " << ex.what() << "\n";
+    return 3;
+  } catch (const std::exception &ex) {
+    std::cerr << "Erreur : " << ex.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/simulation.h"
+#include "core/sweep.h"
+
+// Ligne de commande commune a AppMed et appmed-cli, sans dependance Qt.
+
+// Mode lot et balayage : sortie sur fichier ou sur la sortie standard.
+struct OptionsLot {
+  int replications = 0; // 0 : valeur par defaut du mode
+  int threads = 0;
+  std::string format = "text";
+  std::string output;
+  std::vector<SweepAxis> axes;
+  SweepMode sweep_mode = SweepMode::Grid;
+  bool resume = false;
+};
+
+struct LigneCommande {
+  SimulationConfig config;
+  OptionsLot lot;
+  std::string chrome_trace; // fichier Chrome Trace du run unique
+  bool perf = false;        // compteurs materiels par phase (Linux)
+  bool alloc_stats = false; // allocations et pic memoire par run
+  std::size_t memory_budget = 0; // octets par run (0 : sans limite)
+  bool gui = false;
+  bool aide = false;
+};
+
+void afficher_aide(const char *nom);
+
+// Leve std::invalid_argument sur une option inconnue ou une valeur invalide.
+LigneCommande analyser_arguments(const std::vector<std::string> &args);
+
+// Run unique (resume texte), lot de replications ou balayage selon les
+// options. Retourne le code de sortie du processus (3 : budget memoire
+// depasse).
+int executer_sans_interface(const LigneCommande &ligne);
@@ -0,0 +1,29 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cli.h"
+
+// Executable sans Qt pour les noeuds de calcul : memes options que AppMed,
+// hors --gui. Ne charge que le moteur (appmed_core) au demarrage.
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  LigneCommande ligne;
+  try {
+    ligne = analyser_arguments(args);
+    if (ligne.gui) {
+      throw std::invalid_argument(
+          "appmed-cli est sans interface graphique (utiliser AppMed --gui)");
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << "Erreur : " << ex.what() << "\n";
+    afficher_aide(argv[0]);
+    return 1;
+  }
+  if (ligne.aide) {
+    afficher_aide(argv[0]);
+    return 0;
+  }
+  return executer_sans_interface(ligne);
+}
@@ -0,0 +1,294 @@
+// Benchmark du moteur complet (Simulation::run) sur des hopitaux synthetiques
+// de taille croissante, pour chaque politique d'ordonnancement. Resultats en
+// JSON (un document par execution) pour suivre les regressions de version en
+// version.
+// Usage : bench_engine [--scenario small|medium|large|all] [--days n]
+//                      [--repeats n] [--output fichier] [--perf]
+// --perf ajoute les compteurs materiels par phase et par evenement (Linux,
+// perf_event_open).
+
+#include "core/alloc_tracking.h"
+#include "core/perf_counters.h"
+#include "core/simulation.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Hopital synthetique : ressources et flux journalier, repartis entre
+// programmes (fenetre = tout l'horizon) et urgences (Poisson).
+struct HospitalScale {
+  const char *name;
+  int operating_rooms;
+  int recovery_beds;
+  int surgeons;
+  int patients_per_day;
+  int days;
+};
+
+const HospitalScale kScales[] = {
+    {"small", 2, 3, 3, 20, 1},
+    {"medium", 10, 15, 12, 250, 7},
+    {"large", 40, 60, 45, 2000, 14},
+};
+
+SimulationConfig make_config(const HospitalScale &scale,
+                             SchedulingPolicy policy) {
+  SimulationConfig config;
+  config.horizon_hours = 24.0 * scale.days;
+  config.operating_rooms = scale.operating_rooms;
+  config.recovery_beds = scale.recovery_beds;
+  config.surgeon_count = scale.surgeons;
+  // 40 % de programmes, 60 % d'urgences.
+  config.elective_patients = scale.patients_per_day * scale.days * 2 / 5;
+  config.elective_window_hours = config.horizon_hours;
+  config.urgent_rate_per_hour = scale.patients_per_day * 0.6 / 24.0;
+  config.policy = policy;
+  config.seed = 2024u;
+  return config;
+}
+
+long peak_rss_kb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss; // kilo-octets sous Linux
+}
+
+struct Measure {
+  std::string scenario;
+  std::string policy;
+  int patients = 0;
+  std::uint64_t events = 0;
+  int repeats = 0;
+  double seconds_best = 0.0;
+  double seconds_mean = 0.0;
+  EngineStats profile;
+  // Comptes par appmed_alloc_hooks (portees AllocationScope).
+  AllocationStats memory_cold;
+  std::uint64_t allocations_warm = 0;
+  long peak_rss_kb = 0;
+  bool perf = false; // compteurs materiels mesures
+  std::array<PhaseCounters, kEnginePhases> phases{};
+  std::array<bool, kHardwareCounters> counted{};
+};
+
+Measure measure(const HospitalScale &scale, SchedulingPolicy policy,
+                int repeats, PerfProfiler *perf) {
+  const SimulationConfig config = make_config(scale, policy);
+  Measure m;
+  m.scenario = scale.name;
+  m.policy = scheduling_policy_to_string(policy);
+  m.repeats = repeats;
+
+  // Run a froid : dimensionne les tampons du moteur.
+  AllocationScope cold;
+  Simulation sim(config);
+  const SimulationReport report = sim.run();
+  m.memory_cold = cold.stats();
+  m.patients = report.patients_arrived;
+
+  // Runs chronometres sans compteurs (debit reel), memoire reutilisee.
+  double total = 0.0;
+  m.seconds_best = 1e300;
+  std::uint64_t warm = 0;
+  for (int r = 0; r < repeats; ++r) {
+    AllocationScope scope;
+    const auto start = std::chrono::steady_clock::now();
+    sim.reset(config);
+    sim.run();
+    const auto end = std::chrono::steady_clock::now();
+    warm += scope.stats().allocations;
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    total += seconds;
+    m.seconds_best = std::min(m.seconds_best, seconds);
+  }
+  m.seconds_mean = total / repeats;
+  m.allocations_warm = warm / repeats;
+
+  // Run instrumente a part : ventilation du temps par type d'evenement.
+  SimulationConfig profiled = config;
+  profiled.collect_stats = true;
+  sim.reset(profiled);
+  m.profile = sim.run().engine;
+  m.events = m.profile.total_events();
+
+  // Compteurs materiels sur un run normal (boucle non instrumentee).
+  if (perf && perf->available()) {
+    perf->clear();
+    sim.reset(config);
+    sim.set_profiler(perf);
+    sim.run();
+    sim.set_profiler(nullptr);
+    m.perf = true;
+    for (std::size_t p = 0; p < kEnginePhases; ++p)
+      m.phases[p] = perf->phase(static_cast<EnginePhase>(p));
+    for (std::size_t c = 0; c < kHardwareCounters; ++c)
+      m.counted[c] = perf->counter_available(static_cast<HardwareCounter>(c));
+  }
+  m.peak_rss_kb = peak_rss_kb();
+  return m;
+}
+
+std::string build_description() {
+  std::ostringstream os;
+#if defined(APPMED_EVENT_QUEUE_CALENDAR)
+  os << "{\"event_queue\":\"calendar\"";
+#elif defined(APPMED_EVENT_QUEUE_BINARY)
+  os << "{\"event_queue\":\"binary\"";
+#else
+  os << "{\"event_queue\":\"quaternary\"";
+#endif
+  os << ",\"trace\":" << (kTraceEnabled ? "true" : "false");
+#if defined(APPMED_COMPACT_TIME)
+  os << ",\"compact_time\":true}";
+#else
+  os << ",\"compact_time\":false}";
+#endif
+  return os.str();
+}
+
+void write_json(std::ostream &out, const std::vector<Measure> &measures) {
+  out << "{\"benchmark\":\"engine\",\"build\":" << build_description()
+      << ",\"results\":[";
+  for (std::size_t i = 0; i < measures.size(); ++i) {
+    const Measure &m = measures[i];
+    const double events = static_cast<double>(m.events);
+    out << (i ? "," : "") << "\n  {\"scenario\":\"" << m.scenario
+        << "\",\"policy\":\"" << m.policy << "\",\"patients\":" << m.patients
+        << ",\"events\":" << m.events << ",\"repeats\":" << m.repeats
+        << ",\"seconds_best\":" << m.seconds_best
+        << ",\"seconds_mean\":" << m.seconds_mean
+        << ",\"events_per_second\":" << events / m.seconds_best
+        << ",\"ns_per_event\":" << m.seconds_best * 1e9 / events
+        << ",\"ns_per_event_by_type\":{";
+    for (std::size_t t = 0; t < EngineStats::kEventTypes; ++t) {
+      const std::uint64_t count = m.profile.events[t];
+      out << (t ? "," : "") << '"'
+          << event_type_name(static_cast<EventType>(t)) << "\":"
+          << (count ? static_cast<double>(m.profile.handler_nanoseconds[t]) /
+                          count
+                    : 0.0);
+    }
+    const EngineStats &p = m.profile;
+    out << "},\"ns_per_pick\":"
+        << (p.picks ? static_cast<double>(p.pick_nanoseconds) / p.picks : 0.0)
+        << ",\"max_event_queue\":" << p.max_event_queue
+        << ",\"mean_event_queue\":" << p.mean_event_queue
+        << ",\"max_waiting_surgery\":" << p.max_waiting_surgery
+        << ",\"allocations_cold\":" << m.memory_cold.allocations
+        << ",\"bytes_cold\":" << m.memory_cold.bytes
+        << ",\"peak_live_bytes\":" << m.memory_cold.peak_live_bytes
+        << ",\"allocations_warm\":" << m.allocations_warm
+        << ",\"peak_rss_kb\":" << m.peak_rss_kb;
+    if (m.perf) {
+      // Par evenement traite, pour chaque phase du run.
+      out << ",\"perf_per_event\":{";
+      for (std::size_t p = 0; p < kEnginePhases; ++p) {
+        out << (p ? "," : "") << '"'
+            << PerfProfiler::phase_name(static_cast<EnginePhase>(p)) << "\":{";
+        for (std::size_t c = 0; c < kHardwareCounters; ++c) {
+          out << (c ? "," : "") << '"'
+              << PerfProfiler::counter_name(static_cast<HardwareCounter>(c))
+              << "\":";
+          if (m.counted[c])
+            out << static_cast<double>(m.phases[p].values[c]) / events;
+          else
+            out << "null"; // compteur refuse par le noyau
+        }
+        out << '}';
+      }
+      out << '}';
+    }
+    out << '}';
+  }
+  out << "\n]}\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string scenario = "all";
+  int days = 0; // 0 : duree propre a chaque scenario
+  int repeats = 3;
+  std::string output;
+  bool with_perf = false;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg == "--perf") {
+        with_perf = true;
+        continue;
+      }
+      if (i + 1 >= argc)
+        throw std::invalid_argument("Valeur manquante pour " + arg);
+      const std::string value = argv[++i];
+      if (arg == "--scenario") {
+        scenario = value;
+      } else if (arg == "--days") {
+        days = std::stoi(value);
+      } else if (arg == "--repeats") {
+        repeats = std::max(1, std::stoi(value));
+      } else if (arg == "--output") {
+        output = value;
+      } else {
+        throw std::invalid_argument("Option inconnue : " + arg);
+      }
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << "Erreur : " << ex.what() << "\n"
+              << "Usage : " << argv[0]
+              << " [--scenario small|medium|large|all] [--days n]"
+                 " [--repeats n] [--output fichier] [--perf]\n";
+    return 1;
+  }
+
+  const SchedulingPolicy policies[] = {SchedulingPolicy::Fifo,
+                                       SchedulingPolicy::PriorityFirst,
+                                       SchedulingPolicy::Balanced};
+  // Du plus petit au plus grand : le pic RSS (cumulatif pour le processus)
+  // reste attribuable au scenario courant.
+  std::unique_ptr<PerfProfiler> perf;
+  if (with_perf) {
+    perf = std::make_unique<PerfProfiler>();
+    if (!perf->available()) {
+      std::cerr << "Compteurs materiels indisponibles : " << perf->error()
+                << "\n";
+    }
+  }
+  std::vector<Measure> measures;
+  for (HospitalScale scale : kScales) {
+    if (scenario != "all" && scenario != scale.name)
+      continue;
+    if (days > 0)
+      scale.days = days;
+    for (SchedulingPolicy policy : policies) {
+      measures.push_back(measure(scale, policy, repeats, perf.get()));
+      std::cerr << scale.name << " / " << measures.back().policy << " : "
+                << measures.back().events << " evenements, "
+                << measures.back().seconds_best * 1e3 << " ms\n";
+    }
+  }
+  if (measures.empty()) {
+    std::cerr << "Scenario inconnu : " << scenario << "\n";
+    return 1;
+  }
+
+  if (output.empty()) {
+    write_json(std::cout, measures);
+  } else {
+    std::ofstream out(output);
+    write_json(out, measures);
+  }
+  return 0;
+}
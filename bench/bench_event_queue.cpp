@@ -0,0 +1,105 @@
+// Benchmark des files d'evenements : modele "hold" classique (pop du
+// minimum puis re-insertion plus loin dans le temps) a taille constante.
+// Usage : bench_event_queue [taille_file] [nb_holds]
+
+#include "core/event_queue.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Reference : l'ancienne file de Simulation (comparateur std::function).
+class StdFunctionEventQueue {
+public:
+  StdFunctionEventQueue()
+      : queue_([](const Event &a, const Event &b) { return a.time > b.time; }) {
+  }
+  bool empty() const { return queue_.empty(); }
+  const Event &top() const { return queue_.top(); }
+  void push(const Event &e) { queue_.push(e); }
+  void pop() { queue_.pop(); }
+  void assign(const std::vector<Event> &events) {
+    for (const Event &e : events)
+      queue_.push(e);
+  }
+
+private:
+  std::priority_queue<Event, std::vector<Event>,
+                      std::function<bool(const Event &, const Event &)>>
+      queue_;
+};
+
+struct Workload {
+  std::vector<Event> initial;
+  std::vector<double> increments;
+};
+
+Workload generer(std::size_t taille, std::size_t holds) {
+  std::mt19937_64 rng(2024);
+  std::uniform_real_distribution<double> debut(0.0, 480.0);
+  std::exponential_distribution<double> gap(1.0 / 45.0);
+  Workload w;
+  w.initial.reserve(taille);
+  for (std::size_t i = 0; i < taille; ++i) {
+    w.initial.push_back(
+        Event{debut(rng), EventType::Arrival, static_cast<int>(i)});
+  }
+  w.increments.reserve(holds);
+  for (std::size_t i = 0; i < holds; ++i)
+    w.increments.push_back(gap(rng));
+  return w;
+}
+
+template <typename Queue>
+void mesurer(const std::string &nom, const Workload &w) {
+  Queue queue;
+  queue.assign(w.initial);
+
+  double checksum = 0.0;
+  const auto debut = std::chrono::steady_clock::now();
+  for (double inc : w.increments) {
+    Event e = queue.top();
+    queue.pop();
+    checksum += e.time;
+    e.time += inc;
+    queue.push(e);
+  }
+  const auto fin = std::chrono::steady_clock::now();
+
+  const double secondes = std::chrono::duration<double>(fin - debut).count();
+  // Un hold = un pop + un push, soit deux operations sur la file.
+  const double evenements = 2.0 * static_cast<double>(w.increments.size());
+  std::cout << std::left << std::setw(24) << nom << std::right << std::fixed
+            << std::setprecision(2) << std::setw(10)
+            << evenements / secondes / 1e6 << " M evt/s" << std::setw(10)
+            << secondes * 1e9 / evenements << " ns/evt"
+            << "   (checksum " << std::setprecision(0) << checksum << ")\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::size_t taille = 100000;
+  std::size_t holds = 5000000;
+  if (argc > 1)
+    taille = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2)
+    holds = std::strtoull(argv[2], nullptr, 10);
+
+  const Workload w = generer(taille, holds);
+  std::cout << "Hold : " << taille << " evenements en file, " << holds
+            << " holds\n";
+  mesurer<StdFunctionEventQueue>("priority_queue+function", w);
+  mesurer<BinaryHeapEventQueue>("tas binaire", w);
+  mesurer<QuaternaryHeapEventQueue>("tas 4-aire", w);
+  mesurer<CalendarEventQueue>("file calendrier", w);
+  return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Comptage des allocations par portee (opt-in) : les crochets operator
+// new/delete vivent dans la cible appmed_alloc_hooks, liee seulement par les
+// executables qui en ont besoin (tests, benchmarks, appmed-cli compile avec
+// -DAPPMED_ALLOC_HOOKS=ON). Sans elle, les portees restent a zero.
+
+struct AllocationStats {
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+  std::uint64_t bytes = 0;          // octets demandes
+  // Relatifs a l'ouverture de la portee : la memoire deja detenue (moteur
+  // reutilise) n'y figure pas.
+  std::int64_t live_bytes = 0;      // alloues - liberes dans la portee
+  std::int64_t peak_live_bytes = 0; // maximum de live_bytes
+
+  // Cumul de runs successifs : compteurs additionnes, pic = plus grand pic.
+  void merge(const AllocationStats &other);
+};
+
+// Levee par operator new quand une allocation ferait depasser le budget
+// d'une portee active. Message construit sans allocation. Derivee de
+// std::bad_alloc : le code qui tolere un echec d'allocation la traite comme
+// telle, mais une allocation atteinte depuis un chemin noexcept (destructeur,
+// deplacement de std::function, flux qui avale les exceptions...) terminerait
+// le programme ou perdrait l'erreur.
+class MemoryBudgetExceeded : public std::bad_alloc {
+public:
+  MemoryBudgetExceeded(std::size_t requested, std::int64_t live_bytes,
+                       std::size_t budget);
+  const char *what() const noexcept override { return message_; }
+
+  std::size_t requested() const { return requested_; }
+  std::int64_t live_bytes() const { return live_bytes_; }
+  std::size_t budget() const { return budget_; }
+
+private:
+  std::size_t requested_;
+  std::int64_t live_bytes_;
+  std::size_t budget_;
+  char message_[160];
+};
+
+// Vrai si l'executable lie les crochets (appmed_alloc_hooks).
+bool allocation_tracking_available();
+
+// Compte les allocations du thread courant pendant sa duree de vie. Les
+// portees s'imbriquent : une allocation compte dans toutes les portees
+// actives du thread et doit respecter chacun de leurs budgets (0 : sans
+// limite). La memoire liberee par un autre thread n'est pas decomptee.
+// Une portee avec budget ne doit contenir que du code moteur
+// (Simulation::reset/run, Scenario::generate, sans profileur ni trace) : ce
+// code n'alloue pas sur un chemin noexcept, l'exception remonte donc
+// jusqu'a l'appelant.
+class AllocationScope {
+public:
+  explicit AllocationScope(std::size_t budget_bytes = 0);
+  ~AllocationScope();
+  AllocationScope(const AllocationScope &) = delete;
+  AllocationScope &operator=(const AllocationScope &) = delete;
+
+  const AllocationStats &stats() const { return stats_; }
+  std::size_t budget() const { return budget_; }
+
+private:
+  friend struct AllocationScopeAccess;
+
+  AllocationScope *parent_;
+  std::size_t budget_;
+  AllocationStats stats_;
+};
+
+// Appeles par les crochets operator new/delete.
+namespace alloc_tracking_detail {
+// Leve MemoryBudgetExceeded (rien n'est compte) si un budget est depasse.
+void on_allocate(std::size_t bytes);
+void on_deallocate(std::size_t bytes) noexcept;
+void mark_hooks_installed() noexcept;
+} // namespace alloc_tracking_detail
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+enum class EventType { Arrival, SurgeryEnd, CleaningEnd, RecoveryEnd };
+
+struct Event {
+  double time = 0.0;
+  EventType type = EventType::Arrival;
+  int patient_id = -1;
+  // Numero d'insertion attribue par la file : departage les evenements
+  // simultanes de facon deterministe (premier insere, premier servi).
+  std::uint64_t sequence = 0;
+};
+
+// Ordre total (time, sequence) partage par toutes les files.
+inline bool event_before(const Event &a, const Event &b) {
+  if (a.time != b.time)
+    return a.time < b.time;
+  return a.sequence < b.sequence;
+}
+
+// --- Tas d-aire (binaire, 4-aire...) avec comparateur inline ---
+template <int Arity> class DaryHeapEventQueue {
+  static_assert(Arity >= 2, "Un tas doit avoir au moins deux fils par noeud");
+
+public:
+  bool empty() const { return heap_.empty(); }
+  std::size_t size() const { return heap_.size(); }
+  const Event &top() const { return heap_.front(); }
+
+  void reserve(std::size_t capacity) { heap_.reserve(capacity); }
+
+  void clear() {
+    heap_.clear();
+    next_sequence_ = 0;
+  }
+
+  // push() numerote a partir de `first` : les numeros inferieurs sont
+  // reserves aux evenements inseres par push_sequenced().
+  void reserve_sequences(std::uint64_t first) { next_sequence_ = first; }
+
+  void push(Event event) {
+    event.sequence = next_sequence_++;
+    push_sequenced(event);
+  }
+
+  // Insere en gardant le numero fixe par l'appelant.
+  void push_sequenced(const Event &event) {
+    heap_.push_back(event);
+    sift_up(heap_.size() - 1);
+  }
+
+  void pop() {
+    const Event last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty())
+      sift_down(0, last);
+  }
+
+  // Remplace le contenu par `events` (numerotes dans l'ordre du vecteur).
+  // Une entree deja triee est un tas valide : seule la verification O(n)
+  // est payee, sinon on retombe sur la construction de Floyd en O(n).
+  template <typename Range> void assign(const Range &events) {
+    heap_.assign(std::begin(events), std::end(events));
+    next_sequence_ = 0;
+    for (Event &e : heap_)
+      e.sequence = next_sequence_++;
+    if (std::is_sorted(heap_.begin(), heap_.end(), event_before))
+      return;
+    if (heap_.size() < 2)
+      return;
+    for (std::size_t i = (heap_.size() - 2) / Arity + 1; i-- > 0;)
+      sift_down(i, heap_[i]);
+  }
+
+private:
+  void sift_up(std::size_t index) {
+    const Event moving = heap_[index];
+    while (index > 0) {
+      const std::size_t parent = (index - 1) / Arity;
+      if (!event_before(moving, heap_[parent]))
+        break;
+      heap_[index] = heap_[parent];
+      index = parent;
+    }
+    heap_[index] = moving;
+  }
+
+  // Descend `moving` depuis `index` (technique du trou : pas d'echange).
+  void sift_down(std::size_t index, const Event moving) {
+    const std::size_t count = heap_.size();
+    for (;;) {
+      const std::size_t first = index * Arity + 1;
+      if (first >= count)
+        break;
+      const std::size_t last = std::min(first + Arity, count);
+      std::size_t best = first;
+      for (std::size_t c = first + 1; c < last; ++c) {
+        if (event_before(heap_[c], heap_[best]))
+          best = c;
+      }
+      if (!event_before(heap_[best], moving))
+        break;
+      heap_[index] = heap_[best];
+      index = best;
+    }
+    heap_[index] = moving;
+  }
+
+  std::vector<Event> heap_;
+  std::uint64_t next_sequence_ = 0;
+};
+
+using BinaryHeapEventQueue = DaryHeapEventQueue<2>;
+using QuaternaryHeapEventQueue = DaryHeapEventQueue<4>;
+
+// --- File calendrier (Brown, 1988) : hold en O(1) amorti ---
+// Chaque seau couvre un intervalle de `width_` minutes ; un "jour" virtuel
+// (floor(time / width_)) est range dans le seau jour % nb_seaux. Les seaux
+// sont tries par ordre decroissant pour que le minimum soit en back().
+class CalendarEventQueue {
+public:
+  CalendarEventQueue() { buckets_.resize(kMinBuckets); }
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+  std::size_t bucket_count() const { return bucket_count_; }
+
+  const Event &top() const {
+    locate_min();
+    return buckets_[cached_bucket_].back();
+  }
+
+  // Dimensionne le calendrier pour `capacity` evenements : seaux et tampon
+  // de reconstruction alloues une fois, reutilises d'un run a l'autre.
+  void reserve(std::size_t capacity) {
+    scratch_.reserve(capacity);
+    const std::size_t count =
+        std::max(kMinBuckets, next_power_of_two((capacity + 1) / 2));
+    if (buckets_.size() < count)
+      buckets_.resize(count);
+  }
+
+  void clear() {
+    for (std::size_t b = 0; b < bucket_count_; ++b)
+      buckets_[b].clear();
+    size_ = 0;
+    next_sequence_ = 0;
+    current_day_ = 0;
+    cached_valid_ = false;
+  }
+
+  void reserve_sequences(std::uint64_t first) { next_sequence_ = first; }
+
+  void push(Event event) {
+    event.sequence = next_sequence_++;
+    push_sequenced(event);
+  }
+
+  void push_sequenced(const Event &event) {
+    insert(event);
+    ++size_;
+    if (size_ > 2 * bucket_count_)
+      rebuild(bucket_count_ * 2);
+  }
+
+  void pop() {
+    locate_min();
+    buckets_[cached_bucket_].pop_back();
+    cached_valid_ = false;
+    --size_;
+    // Hysteresis : reduction sous nb_seaux / 4 seulement (croissance au-dela
+    // de 2 * nb_seaux), pour qu'une taille oscillant autour d'un seuil ne
+    // reconstruise pas le calendrier a chaque passage.
+    if (bucket_count_ > kMinBuckets && size_ < bucket_count_ / 4)
+      rebuild(bucket_count_ / 2);
+  }
+
+  // Construction en bloc : largeur estimee sur les donnees, puis une seule
+  // repartition et un tri par seau.
+  template <typename Range> void assign(const Range &events) {
+    clear();
+    scratch_.assign(std::begin(events), std::end(events));
+    for (Event &e : scratch_)
+      e.sequence = next_sequence_++;
+    size_ = scratch_.size();
+    redistribute(std::max<std::size_t>(kMinBuckets, next_power_of_two(size_)));
+  }
+
+private:
+  static constexpr std::size_t kMinBuckets = 16;
+  static constexpr std::size_t kWidthSample = 64;
+
+  static std::size_t next_power_of_two(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n)
+      p <<= 1;
+    return p;
+  }
+
+  static bool event_after(const Event &a, const Event &b) {
+    return event_before(b, a);
+  }
+
+  std::int64_t day_of(double time) const {
+    return static_cast<std::int64_t>(std::floor(time / width_));
+  }
+
+  void insert(const Event &event) {
+    const std::int64_t day = day_of(event.time);
+    if (size_ == 0 || day < current_day_)
+      current_day_ = day;
+    auto &bucket =
+        buckets_[static_cast<std::size_t>(day) & (bucket_count_ - 1)];
+    bucket.insert(
+        std::upper_bound(bucket.begin(), bucket.end(), event, event_after),
+        event);
+    cached_valid_ = false;
+  }
+
+  // Parcourt au plus une "annee" de seaux a partir du jour courant, puis
+  // bascule sur une recherche directe si le calendrier est clairseme.
+  void locate_min() const {
+    if (cached_valid_)
+      return;
+    const std::size_t mask = bucket_count_ - 1;
+    std::int64_t day = current_day_;
+    for (std::size_t n = 0; n < bucket_count_; ++n, ++day) {
+      const std::size_t b = static_cast<std::size_t>(day) & mask;
+      const auto &bucket = buckets_[b];
+      if (!bucket.empty() && day_of(bucket.back().time) == day) {
+        current_day_ = day;
+        cached_bucket_ = b;
+        cached_valid_ = true;
+        return;
+      }
+    }
+    std::size_t best = bucket_count_;
+    for (std::size_t b = 0; b < bucket_count_; ++b) {
+      if (buckets_[b].empty())
+        continue;
+      if (best == bucket_count_ ||
+          event_before(buckets_[b].back(), buckets_[best].back()))
+        best = b;
+    }
+    current_day_ = day_of(buckets_[best].back().time);
+    cached_bucket_ = best;
+    cached_valid_ = true;
+  }
+
+  void rebuild(std::size_t bucket_count) {
+    scratch_.clear();
+    for (std::size_t b = 0; b < bucket_count_; ++b) {
+      scratch_.insert(scratch_.end(), buckets_[b].begin(), buckets_[b].end());
+      buckets_[b].clear();
+    }
+    redistribute(bucket_count);
+  }
+
+  // Repartit scratch_ dans `bucket_count` seaux apres re-estimation de la
+  // largeur : trois fois l'ecart moyen entre les plus petits evenements.
+  // Le tableau de seaux garde sa taille maximale : seul le nombre logique
+  // change, et les seaux (avec leur capacite) ne sont jamais liberes.
+  void redistribute(std::size_t bucket_count) {
+    const std::size_t sample = std::min(scratch_.size(), kWidthSample);
+    if (sample >= 2) {
+      std::partial_sort(scratch_.begin(), scratch_.begin() + sample,
+                        scratch_.end(), event_before);
+      const double span =
+          scratch_[sample - 1].time - scratch_.front().time;
+      if (span > 0.0)
+        width_ = 3.0 * span / static_cast<double>(sample - 1);
+    }
+    for (std::size_t b = 0; b < bucket_count_; ++b)
+      buckets_[b].clear();
+    if (buckets_.size() < bucket_count)
+      buckets_.resize(bucket_count);
+    bucket_count_ = bucket_count;
+    const std::size_t mask = bucket_count - 1;
+    current_day_ = std::numeric_limits<std::int64_t>::max();
+    for (const Event &e : scratch_) {
+      const std::int64_t day = day_of(e.time);
+      current_day_ = std::min(current_day_, day);
+      buckets_[static_cast<std::size_t>(day) & mask].push_back(e);
+    }
+    if (scratch_.empty())
+      current_day_ = 0;
+    for (std::size_t b = 0; b < bucket_count; ++b)
+      std::sort(buckets_[b].begin(), buckets_[b].end(), event_after);
+    scratch_.clear();
+    cached_valid_ = false;
+  }
+
+  std::vector<std::vector<Event>> buckets_; // taille maximale atteinte
+  std::size_t bucket_count_ = kMinBuckets;  // seaux utilises (puissance de 2)
+  std::vector<Event> scratch_;
+  double width_ = 1.0;
+  std::size_t size_ = 0;
+  std::uint64_t next_sequence_ = 0;
+  mutable std::int64_t current_day_ = 0;
+  mutable std::size_t cached_bucket_ = 0;
+  mutable bool cached_valid_ = false;
+};
+
+// Selection a la compilation (option CMake APPMED_EVENT_QUEUE).
+#if defined(APPMED_EVENT_QUEUE_CALENDAR)
+using SimulationEventQueue = CalendarEventQueue;
+#elif defined(APPMED_EVENT_QUEUE_BINARY)
+using SimulationEventQueue = BinaryHeapEventQueue;
+#else
+using SimulationEventQueue = QuaternaryHeapEventQueue;
+#endif
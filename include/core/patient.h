@@ -1,6 +1,11 @@
 #pragma once
 
-enum class PatientType { Elective, Urgent };
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+enum class PatientType : std::uint8_t { Elective, Urgent };
 
 struct Patient {
   int id = -1;
@@ -23,4 +28,110 @@ struct Patient {
 
   bool is_urgent() const;
   bool is_completed() const;
-};
\ No newline at end of file
+};
+
+// Encodage des temps dans les colonnes : double par défaut (mêmes valeurs
+// que Patient) ; float32 avec APPMED_COMPACT_TIME, qui divise par deux les
+// seules colonnes de temps (~0,03 min de résolution sur un an).
+#if defined(APPMED_COMPACT_TIME)
+using patient_time_t = float;
+#else
+using patient_time_t = double;
+#endif
+
+struct PatientTable;
+
+// Vue ligne en lecture sur une PatientTable : des références vers les
+// colonnes, sans copie. Mêmes noms de champs que Patient ; la conversion en
+// Patient fait la copie quand elle est voulue. Invalide dès que la table
+// est modifiée.
+class PatientRef {
+public:
+  inline PatientRef(const PatientTable &table, std::size_t index);
+
+  const int &id;
+  const PatientType &type;
+  const patient_time_t &arrival_time;
+  const patient_time_t &surgery_duration;
+  const patient_time_t &recovery_duration;
+  const patient_time_t &start_surgery_time;
+  const patient_time_t &end_surgery_time;
+  const patient_time_t &start_recovery_time;
+  const patient_time_t &end_recovery_time;
+
+  bool is_urgent() const { return type == PatientType::Urgent; }
+  bool is_completed() const { return end_recovery_time >= 0; }
+  operator Patient() const;
+};
+
+// Stockage des patients en colonnes (SoA) : les boucles qui ne lisent que
+// deux ou trois champs ne parcourent que ces colonnes. operator[] et les
+// itérateurs donnent une vue PatientRef pour le code écrit par ligne.
+struct PatientTable {
+  std::vector<int> id;
+  std::vector<PatientType> type;
+  std::vector<patient_time_t> arrival_time;
+  std::vector<patient_time_t> surgery_duration;
+  std::vector<patient_time_t> recovery_duration;
+  std::vector<patient_time_t> start_surgery_time;
+  std::vector<patient_time_t> end_surgery_time;
+  std::vector<patient_time_t> start_recovery_time;
+  std::vector<patient_time_t> end_recovery_time;
+
+  class const_iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Patient;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = PatientRef;
+
+    const_iterator(const PatientTable *table, std::size_t index)
+        : table_(table), index_(index) {}
+    PatientRef operator*() const { return PatientRef(*table_, index_); }
+    const_iterator &operator++() {
+      ++index_;
+      return *this;
+    }
+    bool operator==(const const_iterator &o) const {
+      return index_ == o.index_;
+    }
+    bool operator!=(const const_iterator &o) const {
+      return index_ != o.index_;
+    }
+
+  private:
+    const PatientTable *table_;
+    std::size_t index_;
+  };
+
+  std::size_t size() const { return id.size(); }
+  bool empty() const { return id.empty(); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  void clear();
+  void reserve(std::size_t capacity);
+  void push_back(const Patient &p);
+  // Remplace la ligne `index` (recyclage d'un emplacement libre).
+  void set_row(std::size_t index, const Patient &p);
+
+  // Vue ligne du patient stocké à l'indice `index`.
+  PatientRef operator[](std::size_t index) const {
+    return PatientRef(*this, index);
+  }
+
+  // Copie réordonnée par heure d'arrivée (ordre stable).
+  PatientTable sorted_by_arrival() const;
+  std::vector<Patient> to_vector() const;
+};
+
+inline PatientRef::PatientRef(const PatientTable &table, std::size_t index)
+    : id(table.id[index]), type(table.type[index]),
+      arrival_time(table.arrival_time[index]),
+      surgery_duration(table.surgery_duration[index]),
+      recovery_duration(table.recovery_duration[index]),
+      start_surgery_time(table.start_surgery_time[index]),
+      end_surgery_time(table.end_surgery_time[index]),
+      start_recovery_time(table.start_recovery_time[index]),
+      end_recovery_time(table.end_recovery_time[index]) {}
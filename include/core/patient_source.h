@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include "core/patient.h"
+#include "core/rng.h"
+#include "core/variates.h"
+
+struct SimulationConfig;
+
+// Generateur de patients a la demande : programmes et urgences sont produits
+// un par un dans l'ordre de leurs arrivees, chaque classe sur ses propres
+// flux. Lire toute la liste d'un coup (mode batch) ou un patient d'avance
+// (mode flux) donne exactement les memes patients.
+class PatientSource {
+public:
+  // Taille maximale d'un bloc de tirages : borne la memoire du mode flux.
+  static constexpr std::size_t kMaxChunk = 512;
+
+  void reset(const SimulationConfig &config);
+
+  // Faux quand la classe est epuisee (tous les programmes emis, ou arrivee
+  // d'urgence au-dela de l'horizon). Les ids suivent l'ordre batch :
+  // programmes 0..n-1, puis urgences.
+  bool next_elective(RandomStreams &streams, Patient &out);
+  bool next_urgent(RandomStreams &streams, Patient &out);
+
+  int elective_count() const { return elective_count_; }
+
+private:
+  double horizon_minutes_ = 0.0;
+  double elective_window_minutes_ = 0.0;
+  int elective_count_ = 0;
+  int electives_emitted_ = 0;
+  int urgents_emitted_ = 0;
+  bool urgents_exhausted_ = true;
+  double urgent_clock_ = 0.0;
+
+  TruncatedNormalSampler elective_surgery_;
+  TruncatedNormalSampler elective_recovery_;
+  TruncatedNormalSampler urgent_surgery_;
+  TruncatedNormalSampler urgent_recovery_;
+  ExponentialSampler urgent_gaps_;
+};
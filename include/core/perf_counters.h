@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/profiler.h"
+
+// Compteurs materiels lus autour des phases d'un run (Linux,
+// perf_event_open, espace utilisateur du thread courant uniquement).
+enum class HardwareCounter : std::uint8_t {
+  Cycles,
+  Instructions,
+  BranchMisses,
+  LlcMisses // defauts du dernier niveau de cache (lectures)
+};
+
+inline constexpr std::size_t kHardwareCounters = 4;
+inline constexpr std::size_t kEnginePhases = 3;
+
+struct PhaseCounters {
+  std::array<std::uint64_t, kHardwareCounters> values{};
+  std::uint64_t nanoseconds = 0;
+  int runs = 0; // passages cumules dans la phase
+};
+
+// Profileur de phases : n'active pas l'instance instrumentee du moteur, la
+// boucle mesuree est celle d'un run normal (sauf collect_stats). Les
+// compteurs s'additionnent sur les runs jusqu'a clear(). Quand le noyau
+// multiplexe les compteurs (plus de compteurs que de registres PMU), chaque
+// valeur de phase est extrapolee au temps ou elle etait active. Hors Linux,
+// ou si le noyau refuse l'acces (perf_event_paranoid, conteneur, machine
+// virtuelle sans PMU), available() est faux et error() explique pourquoi.
+class PerfProfiler : public EngineProfiler {
+public:
+  PerfProfiler();
+  ~PerfProfiler() override;
+  PerfProfiler(const PerfProfiler &) = delete;
+  PerfProfiler &operator=(const PerfProfiler &) = delete;
+
+  bool available() const;
+  bool counter_available(HardwareCounter counter) const;
+  const std::string &error() const { return error_; }
+
+  bool event_detail() const override { return false; }
+  void enter(EnginePhase phase) override;
+  void leave(EnginePhase phase) override;
+
+  const PhaseCounters &phase(EnginePhase phase) const;
+  void clear();
+
+  static const char *counter_name(HardwareCounter counter);
+  static const char *phase_name(EnginePhase phase);
+
+private:
+  // Lecture brute : valeur et temps actif / effectivement compte (ns).
+  struct Reading {
+    std::uint64_t value = 0;
+    std::uint64_t enabled = 0;
+    std::uint64_t running = 0;
+  };
+
+  void read_all(std::array<Reading, kHardwareCounters> &out) const;
+
+  std::array<int, kHardwareCounters> fds_{{-1, -1, -1, -1}};
+  std::array<Reading, kHardwareCounters> started_{};
+  std::chrono::steady_clock::time_point started_time_;
+  std::array<PhaseCounters, kEnginePhases> phases_{};
+  std::string error_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/patient.h"
+#include "core/trace.h"
+
+enum class SchedulingPolicy { Fifo, PriorityFirst, Balanced };
+
+// Politiques d'ordonnancement sous forme de types : le moteur est instancie
+// pour chacune, la cle de priorite est calculee sans aucun switch.
+// rank() : plus petit = prioritaire (egalites departagees par l'arrivee).
+struct FifoPolicy {
+  static constexpr SchedulingPolicy kind = SchedulingPolicy::Fifo;
+  static double rank(PatientType, double arrival) { return arrival; }
+};
+
+struct PriorityFirstPolicy {
+  static constexpr SchedulingPolicy kind = SchedulingPolicy::PriorityFirst;
+  static double rank(PatientType type, double) {
+    return (type == PatientType::Urgent) ? 0.0 : 1.0;
+  }
+};
+
+struct BalancedPolicy {
+  static constexpr SchedulingPolicy kind = SchedulingPolicy::Balanced;
+  // Score = poids(type) + (now - arrivee) / 60 : comparer deux scores au
+  // meme instant revient a comparer arrivee - 60 * poids (plus petit =
+  // prioritaire), independamment de now.
+  static double rank(PatientType type, double arrival) {
+    return arrival - 60.0 * ((type == PatientType::Urgent) ? 2.0 : 1.0);
+  }
+};
+
+// Modes d'instrumentation : trace des evenements et compteurs du moteur
+// (EngineStats). Desactives, leurs appels disparaissent a la compilation de
+// l'instance correspondante.
+template <bool Trace, bool Stats> struct EngineMode {
+  static constexpr bool trace = Trace && kTraceEnabled;
+  static constexpr bool stats = Stats;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/patient.h"
+
+enum class ResourceKind : std::uint8_t { OperatingRoom, Surgeon, RecoveryBed };
+
+// Phases d'un run : tirage des patients, boucle d'evenements, rapport.
+enum class EnginePhase : std::uint8_t { Seeding, EventLoop, Report };
+
+// Recoit l'execution d'un run (Simulation::set_profiler) : les phases du
+// run puis, si event_detail(), des portions de calcul en temps reel et
+// l'occupation des ressources en temps simule. Les occupations arrivent dans
+// l'ordre de leur debut.
+class EngineProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  virtual ~EngineProfiler() = default;
+  virtual void begin_run() {}
+  virtual void enter(EnginePhase) {}
+  virtual void leave(EnginePhase) {}
+  // Vrai : le run passe par l'instance instrumentee du moteur (spans par
+  // handler, occupations). Faux : boucle non instrumentee, phases seules.
+  virtual bool event_detail() const { return true; }
+  // Portion de calcul : run, seed_patients, handlers, pick_next_patient.
+  virtual void span(const char * /*name*/, Clock::time_point /*start*/,
+                    Clock::time_point /*end*/) {}
+  // Ressource occupee par un patient (id d'origine, y compris en mode
+  // flux) de start a end (minutes simulees).
+  virtual void occupancy(ResourceKind /*kind*/, int /*patient_id*/,
+                         PatientType /*type*/, double /*start*/,
+                         double /*end*/) {}
+};
+
+// Ecrit le format Chrome Trace Event (JSON, lisible par Perfetto et
+// chrome://tracing) au fil de l'eau. Processus 1 : calcul du moteur (temps
+// reel, microsecondes). Processus 2, 3... : un par run, une piste par salle,
+// chirurgien et lit (1 minute simulee = 1 seconde affichee). Chaque
+// occupation prend la premiere piste libre de sa ressource. Les nombres sont
+// formates a part (locale C, virgule fixe) : l'etat du flux de l'appelant
+// n'est pas modifie. Le document est ferme par finish() ou par le
+// destructeur.
+class ChromeTraceWriter : public EngineProfiler {
+public:
+  explicit ChromeTraceWriter(std::ostream &out);
+  ~ChromeTraceWriter() override;
+
+  void begin_run() override;
+  void span(const char *name, Clock::time_point start,
+            Clock::time_point end) override;
+  void occupancy(ResourceKind kind, int patient_id, PatientType type,
+                 double start, double end) override;
+  void finish();
+
+  // Pistes ouvertes pour une ressource dans le run courant.
+  std::size_t lanes(ResourceKind kind) const;
+
+private:
+  std::ostream &begin_event();
+  void end_event();
+  void metadata(const char *name, int pid, int tid, const char *key,
+                const std::string &value);
+
+  std::ostream &out_;
+  std::ostringstream line_; // evenement en cours de formatage
+  Clock::time_point origin_;
+  bool first_ = true;
+  bool finished_ = false;
+  int run_pid_ = 1;
+  // Fin de la derniere occupation de chaque piste, par ressource.
+  std::vector<double> lanes_[3];
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cle d'ordonnancement d'un patient en attente de bloc. Elle est calculee
+// une seule fois a l'entree dans la file : pour toutes les politiques
+// integrees, l'ordre entre deux patients ne depend pas de l'instant `now`.
+struct ReadyKey {
+  double rank = 0.0;    // critere principal (plus petit = servi d'abord)
+  double arrival = 0.0; // departage : premier arrive
+  int patient_id = -1;  // ligne du patient (emplacement en mode flux)
+  // Departage final : rang d'arrivee d'origine, independant des
+  // emplacements recycles du mode flux.
+  std::uint64_t sequence = 0;
+};
+
+inline bool ready_before(const ReadyKey &a, const ReadyKey &b) {
+  if (a.rank != b.rank)
+    return a.rank < b.rank;
+  if (a.arrival != b.arrival)
+    return a.arrival < b.arrival;
+  if (a.sequence != b.sequence)
+    return a.sequence < b.sequence;
+  return a.patient_id < b.patient_id;
+}
+
+// Tas binaire indexe par identifiant patient : selection du meilleur en
+// O(1), insertion et retrait (du meilleur ou d'un patient quelconque) en
+// O(log n).
+class ReadyQueue {
+public:
+  bool empty() const { return heap_.empty(); }
+  std::size_t size() const { return heap_.size(); }
+
+  bool contains(int patient_id) const {
+    return patient_id >= 0 &&
+           static_cast<std::size_t>(patient_id) < position_.size() &&
+           position_[patient_id] >= 0;
+  }
+
+  const ReadyKey &top() const { return heap_.front(); }
+
+  void reserve(std::size_t patients) {
+    heap_.reserve(patients);
+    position_.reserve(patients);
+  }
+
+  void clear() {
+    for (const ReadyKey &k : heap_)
+      position_[k.patient_id] = -1;
+    heap_.clear();
+  }
+
+  void push(const ReadyKey &key) {
+    if (static_cast<std::size_t>(key.patient_id) >= position_.size())
+      position_.resize(key.patient_id + 1, -1);
+    heap_.push_back(key);
+    sift_up(heap_.size() - 1);
+  }
+
+  // Retire et renvoie l'identifiant du patient prioritaire.
+  int pop() {
+    const int patient_id = heap_.front().patient_id;
+    remove_at(0);
+    return patient_id;
+  }
+
+  // Retire un patient quelconque (annulation, transfert...).
+  bool erase(int patient_id) {
+    if (!contains(patient_id))
+      return false;
+    remove_at(static_cast<std::size_t>(position_[patient_id]));
+    return true;
+  }
+
+private:
+  void place(std::size_t index, const ReadyKey &key) {
+    heap_[index] = key;
+    position_[key.patient_id] = static_cast<int>(index);
+  }
+
+  void remove_at(std::size_t index) {
+    position_[heap_[index].patient_id] = -1;
+    const ReadyKey last = heap_.back();
+    heap_.pop_back();
+    if (index == heap_.size())
+      return;
+    place(index, last);
+    if (index > 0 && ready_before(last, heap_[(index - 1) / 2]))
+      sift_up(index);
+    else
+      sift_down(index);
+  }
+
+  void sift_up(std::size_t index) {
+    const ReadyKey moving = heap_[index];
+    while (index > 0) {
+      const std::size_t parent = (index - 1) / 2;
+      if (!ready_before(moving, heap_[parent]))
+        break;
+      place(index, heap_[parent]);
+      index = parent;
+    }
+    place(index, moving);
+  }
+
+  void sift_down(std::size_t index) {
+    const ReadyKey moving = heap_[index];
+    const std::size_t count = heap_.size();
+    for (;;) {
+      std::size_t best = 2 * index + 1;
+      if (best >= count)
+        break;
+      if (best + 1 < count && ready_before(heap_[best + 1], heap_[best]))
+        ++best;
+      if (!ready_before(heap_[best], moving))
+        break;
+      place(index, heap_[best]);
+      index = best;
+    }
+    place(index, moving);
+  }
+
+  std::vector<ReadyKey> heap_;
+  std::vector<int> position_; // position dans heap_, -1 si absent
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/patient.h"
+
+// Etat affiche d'un patient pendant le rejeu d'un run precalcule.
+enum class ReplayState : std::uint8_t {
+  NotArrived,
+  Waiting,     // arrive, sera opere
+  Unscheduled, // arrive, jamais opere (horizon pas encore atteint)
+  Cancelled,   // jamais opere, horizon atteint
+  InSurgery,
+  AwaitingBed, // chirurgie finie, pas encore de lit de reveil
+  InRecovery,
+  Discharged
+};
+
+inline constexpr std::size_t kReplayStates = 8;
+
+struct ReplayTransition {
+  double time = 0.0;
+  std::uint32_t row = 0; // ligne de la table rejouee
+  ReplayState state = ReplayState::NotArrived;
+  ReplayState from = ReplayState::NotArrived; // etat precedent de la ligne
+};
+
+// Rejeu par deltas : la table des patients est convertie une fois en flux
+// de transitions trie par temps ; advance(t) n'applique que les transitions
+// franchies depuis l'appel precedent et tient a jour un compteur par etat.
+// Le cout d'un pas est proportionnel aux changements, pas au nombre de
+// patients.
+//
+// seek(t) saute a n'importe quel instant, dans les deux sens : compteurs
+// repris de l'image cle precedente (une toutes les kKeyframeInterval
+// transitions) puis au plus kKeyframeInterval transitions rejouees ; etat
+// des lignes touchees lu dans l'index des phases de chaque patient.
+class ReplayCursor {
+public:
+  static constexpr std::size_t kKeyframeInterval = 256;
+
+  ReplayCursor() = default;
+  // late_threshold : attente (minutes) au-dela de laquelle un patient
+  // opere est compte en retard, des qu'elle est depassee.
+  ReplayCursor(const PatientTable &patients, double horizon_minutes,
+               double late_threshold_minutes = 15.0);
+
+  // Applique les transitions de temps <= t (t croissant d'un appel a
+  // l'autre ; un t plus petit est ignore).
+  void advance(double t);
+  // Positionne le rejeu a t (avant ou arriere). changed_rows() liste alors
+  // les lignes dont l'etat differe de la position precedente.
+  void seek(double t);
+  // Etat de la ligne a l'instant t, sans deplacer le curseur.
+  ReplayState state_at(std::size_t row, double t) const;
+
+  // Lignes dont l'etat a change lors du dernier advance() ou seek(), sans
+  // doublon.
+  const std::vector<std::uint32_t> &changed_rows() const { return changed_; }
+  // Lignes en attente du bloc (Waiting, Unscheduled, Cancelled), dont
+  // l'attente affichee augmente a chaque pas.
+  const std::vector<std::uint32_t> &waiting_rows() const { return waiting_; }
+
+  ReplayState state(std::size_t row) const { return states_[row]; }
+  int count(ReplayState state) const {
+    return counts_[static_cast<std::size_t>(state)];
+  }
+  // Patients operes ou en attente dont l'attente depasse le seuil a t.
+  int late() const { return late_; }
+  // Une salle ou un lit reste occupe (ou le sera) tant que t < activity_end.
+  double activity_end() const { return activity_end_; }
+  double time() const { return time_; }
+
+  std::size_t size() const { return states_.size(); }
+  const std::vector<ReplayTransition> &transitions() const {
+    return transitions_;
+  }
+  bool finished() const { return next_ == transitions_.size(); }
+
+private:
+  void set_waiting(std::uint32_t row, bool waiting);
+  void mark_changed(std::uint32_t row);
+  void update_late(double t);
+
+  std::vector<ReplayTransition> transitions_;
+  // Index des phases : transitions de la ligne r dans
+  // phases_[phase_offsets_[r], phase_offsets_[r + 1]), par temps croissant.
+  std::vector<std::uint32_t> phase_offsets_;
+  std::vector<ReplayTransition> phases_;
+  // keyframes_[k] : compteurs avant la transition k * kKeyframeInterval.
+  std::vector<std::array<int, kReplayStates>> keyframes_;
+  std::vector<double> late_times_; // tries : retard compte si < t
+  std::vector<ReplayState> states_;
+  std::vector<std::uint32_t> changed_;
+  std::vector<std::uint8_t> changed_mark_;
+  std::vector<std::uint32_t> waiting_;
+  std::vector<std::uint32_t> waiting_slot_; // position dans waiting_
+  std::array<int, kReplayStates> counts_{};
+  std::size_t next_ = 0;
+  int late_ = 0;
+  double time_ = 0.0;
+  double activity_end_ = 0.0;
+};
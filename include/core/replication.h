@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/alloc_tracking.h"
+#include "core/simulation.h"
+#include "core/statistics.h"
+
+// Indicateur extrait d'un SimulationReport (nom = nom du champ).
+struct ReportMetric {
+  const char *name;
+  double (*extract)(const SimulationReport &report);
+};
+
+// KPI agreges, dans l'ordre des champs de SimulationReport.
+const std::vector<ReportMetric> &report_metrics();
+
+// Agregat de replications : un RunningStat par KPI de report_metrics().
+// merge() est associatif ; l'agregat d'un lot ne depend que de l'ordre des
+// replications, pas du nombre de threads qui les ont produites.
+struct ReplicationSummary {
+  ReplicationSummary();
+  // Agregat d'une seule replication : unite de fusion des lots.
+  static ReplicationSummary single(const SimulationReport &report);
+
+  std::vector<RunningStat> metrics;
+
+  int replications() const;
+  void add(const SimulationReport &report);
+  // Ajoute l'ecart apparie report - reference, KPI par KPI.
+  void add_difference(const SimulationReport &report,
+                      const SimulationReport &reference);
+  void merge(const ReplicationSummary &other);
+  // Leve std::out_of_range si le KPI est inconnu.
+  const RunningStat &metric(const std::string &name) const;
+};
+
+// Comparaison de variantes en nombres aleatoires communs (CRN).
+struct ComparisonSummary {
+  std::vector<ReplicationSummary> variants;
+  // Ecarts apparies variante i - variante 0, replication par replication :
+  // leur intervalle de confiance tient compte de la correlation induite
+  // par les scenarios communs.
+  std::vector<ReplicationSummary> differences;
+};
+
+// Lance N replications independantes d'une configuration sur un pool de
+// threads (un moteur Simulation reutilise par thread). La replication i
+// tire ses nombres du i-eme flux de ReplicationStreams(base.seed).
+class ReplicationRunner {
+public:
+  // threads <= 0 : autant que de coeurs disponibles.
+  explicit ReplicationRunner(SimulationConfig base, int threads = 0);
+
+  ReplicationSummary run(int replications);
+
+  // Mode CRN : chaque replication genere un Scenario une seule fois depuis
+  // la configuration de base, puis evalue toutes les variantes (politique,
+  // salles, lits, chirurgiens...) dessus. Leve std::invalid_argument si une
+  // variante modifie le flux de patients.
+  ComparisonSummary compare(const std::vector<SimulationConfig> &variants,
+                            int replications);
+
+  // Budget memoire par replication en octets (0 : sans limite). Un
+  // depassement arrete le lot : run() et compare() levent
+  // MemoryBudgetExceeded. Effectif seulement avec appmed_alloc_hooks.
+  void set_memory_budget(std::size_t bytes) { memory_budget_ = bytes; }
+
+  // Rapports individuels du dernier run(), indexes par replication.
+  const std::vector<SimulationReport> &reports() const { return reports_; }
+  // Allocations du dernier run() ou compare(), indexees par replication
+  // (toutes les variantes d'une replication CRN). La premiere replication
+  // d'un thread inclut le dimensionnement de son moteur ; les suivantes ne
+  // comptent que la memoire qu'elles ajoutent.
+  const std::vector<AllocationStats> &allocations() const {
+    return allocations_;
+  }
+  int threads() const { return threads_; }
+
+private:
+  SimulationConfig base_;
+  int threads_ = 1;
+  std::size_t memory_budget_ = 0;
+  std::vector<SimulationReport> reports_;
+  std::vector<AllocationStats> allocations_;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "core/sweep.h"
+
+// Formats machine : une ligne par enregistrement, ecrite et videe des
+// qu'elle est prete (lecture possible pendant le calcul).
+enum class OutputFormat { Csv, JsonLines };
+
+// "csv" ou "jsonl" ; leve std::invalid_argument sinon.
+OutputFormat parse_output_format(const std::string &value);
+
+// Lot de replications : un enregistrement par replication puis un agregat.
+// CSV : colonnes record, replication, statistic puis un KPI par colonne ;
+// lignes "run" (statistic = value) puis une ligne "summary" par statistique
+// (mean, stddev, ci95, ci95_low, ci95_high, min, max).
+// JSON lines : {"record":"run","replication","seed","metrics":{kpi:valeur}}
+// (+ "engine" : compteurs du moteur si config.collect_stats ; + "memory" :
+// allocations, deallocations, bytes, peak_live_bytes si memory est fourni)
+// puis {"record":"summary","replications","seed",
+// "metrics":{kpi:{mean,stddev,ci95,ci95_low,ci95_high,min,max}}}.
+class BatchWriter {
+public:
+  BatchWriter(std::ostream &out, OutputFormat format, unsigned int seed);
+
+  // memory : allocations du run (JSON lines seulement), optionnel.
+  void write_run(int replication, const SimulationReport &report,
+                 const AllocationStats *memory = nullptr);
+  void write_summary(const ReplicationSummary &summary);
+
+private:
+  std::ostream &out_;
+  OutputFormat format_;
+  unsigned int seed_;
+};
+
+// Points de balayage : colonnes point, <axes>, replications puis, par KPI,
+// <kpi>_mean, <kpi>_stddev, <kpi>_ci95 (CSV) ; objet
+// {"point", "config", "replications", "metrics"} par ligne (JSON lines),
+// + "memory" si SweepDefinition::track_memory.
+// Empreinte de la definition (SweepDefinition::fingerprint) en premiere
+// ligne si fournie : "# definition=<empreinte>" avant l'en-tete CSV, objet
+// {"definition":"<empreinte>"} en JSON lines.
+class SweepWriter : public SweepSink {
+public:
+  // header : ecrit l'en-tete (faux lors d'une reprise en ajout).
+  SweepWriter(std::ostream &out, OutputFormat format,
+              std::vector<std::string> axes, bool header = true,
+              const std::string &definition = std::string());
+
+  void write_point(const SweepPointResult &result) override;
+
+private:
+  std::ostream &out_;
+  OutputFormat format_;
+  std::vector<std::string> axes_;
+};
+
+// Reprise d'un balayage : relit un fichier de sortie, tronque une derniere
+// ligne incomplete (arret brutal) et retourne les points deja ecrits.
+// Fichier absent : aucun point. Si `definition` est fournie, un fichier non
+// vide doit porter cette empreinte : sinon std::invalid_argument, avant toute
+// modification du fichier.
+std::vector<std::size_t>
+recover_sweep_output(const std::string &path, OutputFormat format,
+                     const std::string &definition = std::string());
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+
+// Generateur xoshiro256++ (Blackman & Vigna) : rapide, periode 2^256 - 1,
+// avec sauts de 2^128 (jump) et 2^192 (long_jump) pour decouper la suite en
+// flux independants. Compatible UniformRandomBitGenerator.
+class Xoshiro256PlusPlus {
+public:
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro256PlusPlus(std::uint64_t seed_value = 0) {
+    seed(seed_value);
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type(0); }
+
+  // Etat initialise par SplitMix64 (jamais entierement nul).
+  void seed(std::uint64_t seed_value) {
+    for (std::uint64_t &word : s_) {
+      seed_value += 0x9e3779b97f4a7c15ULL;
+      std::uint64_t z = seed_value;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  result_type operator()() {
+    const std::uint64_t result = rotl(s_[0] + s_[3], 23) + s_[0];
+    const std::uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // Uniforme dans [0, 1) sur 53 bits.
+  double next_double() {
+    return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+  }
+
+  // Avance de 2^128 tirages : sous-flux d'une meme replication.
+  void jump() {
+    static const std::uint64_t kJump[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+        0x39abdc4529b1661cULL};
+    apply(kJump);
+  }
+
+  // Avance de 2^192 tirages : une replication par long_jump.
+  void long_jump() {
+    static const std::uint64_t kLongJump[] = {
+        0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL,
+        0x39109bb02acbe635ULL};
+    apply(kLongJump);
+  }
+
+  bool operator==(const Xoshiro256PlusPlus &other) const {
+    return s_[0] == other.s_[0] && s_[1] == other.s_[1] &&
+           s_[2] == other.s_[2] && s_[3] == other.s_[3];
+  }
+  bool operator!=(const Xoshiro256PlusPlus &other) const {
+    return !(*this == other);
+  }
+
+private:
+  static std::uint64_t rotl(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  void apply(const std::uint64_t (&polynomial)[4]) {
+    std::uint64_t acc[4] = {0, 0, 0, 0};
+    for (std::uint64_t word : polynomial) {
+      for (int bit = 0; bit < 64; ++bit) {
+        if (word & (std::uint64_t(1) << bit)) {
+          for (int i = 0; i < 4; ++i)
+            acc[i] ^= s_[i];
+        }
+        (*this)();
+      }
+    }
+    for (int i = 0; i < 4; ++i)
+      s_[i] = acc[i];
+  }
+
+  std::uint64_t s_[4];
+};
+
+// Sous-flux d'une replication, un par usage et par classe de patient : les
+// tirages d'un usage ne dependent ni des autres usages ni de l'ordre dans
+// lequel programmes et urgences sont generes.
+struct RandomStreams {
+  Xoshiro256PlusPlus urgent_arrivals;
+  Xoshiro256PlusPlus elective_surgery;
+  Xoshiro256PlusPlus urgent_surgery;
+  Xoshiro256PlusPlus elective_recovery;
+  Xoshiro256PlusPlus urgent_recovery;
+
+  // Decoupe le flux d'une replication en sous-flux separes par jump().
+  explicit RandomStreams(Xoshiro256PlusPlus base) {
+    Xoshiro256PlusPlus *streams[] = {&urgent_arrivals, &elective_surgery,
+                                     &urgent_surgery, &elective_recovery,
+                                     &urgent_recovery};
+    for (Xoshiro256PlusPlus *stream : streams) {
+      *stream = base;
+      base.jump();
+    }
+  }
+
+  // Flux de la replication 0 pour une graine (run unique).
+  static RandomStreams from_seed(std::uint64_t seed) {
+    return RandomStreams(Xoshiro256PlusPlus(seed));
+  }
+};
+
+// Fournit les flux des replications successives d'une graine : la
+// replication i part de la graine avancee de i long_jump(). Le decoupage ne
+// depend que de l'indice, jamais du thread qui execute la replication.
+class ReplicationStreams {
+public:
+  explicit ReplicationStreams(std::uint64_t seed) : base_(seed) {}
+
+  RandomStreams next() {
+    RandomStreams streams(base_);
+    base_.long_jump();
+    return streams;
+  }
+
+private:
+  Xoshiro256PlusPlus base_;
+};
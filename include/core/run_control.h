@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+// Levee par Simulation::run() quand l'annulation a ete demandee : le run est
+// abandonne, le moteur reste utilisable apres reset().
+class SimulationCancelled : public std::runtime_error {
+public:
+  SimulationCancelled() : std::runtime_error("simulation annulee") {}
+};
+
+// Pilotage d'un run depuis un autre thread : progression en temps simule et
+// annulation cooperative. Le moteur consulte l'objet toutes les
+// kCheckInterval evenements, jamais dans la boucle sinon.
+class RunControl {
+public:
+  static constexpr std::uint32_t kCheckInterval = 1024;
+  static constexpr int kProgressSteps = 100;
+
+  // Rappel sur le thread du run a chaque palier franchi (au plus
+  // kProgressSteps fois par run, puis une fois a la fin) : temps simule et
+  // horizon, en minutes. A definir avant le run.
+  std::function<void(double, double)> on_progress;
+
+  // Depuis n'importe quel thread ; le run s'arrete au prochain point de
+  // controle.
+  void request_cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  bool cancel_requested() const {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+  // Dernier temps simule publie par le moteur (minutes).
+  double simulated_minutes() const {
+    return simulated_.load(std::memory_order_relaxed);
+  }
+
+  // Appels du moteur. checkpoint() et begin() levent SimulationCancelled si
+  // l'annulation a ete demandee.
+  void begin(double horizon_minutes);
+  void checkpoint(double now);
+  void finish();
+
+private:
+  void publish(double now);
+
+  std::atomic<bool> cancelled_{false};
+  std::atomic<double> simulated_{0.0};
+  double horizon_ = 0.0;
+  int step_ = -1; // dernier palier signale
+};
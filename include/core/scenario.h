@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/patient.h"
+#include "core/patient_source.h"
+#include "core/rng.h"
+#include "core/simulation.h"
+
+// Flux de patients fige : arrivees et durees echantillonnees une fois, puis
+// rejouees telles quelles par plusieurs simulations (nombres aleatoires
+// communs). Seuls les champs de flux de la configuration (horizon, volumes,
+// taux, durees moyennes) interviennent dans la generation.
+struct Scenario {
+  SimulationConfig config; // configuration de generation
+  PatientTable patients;   // timestamps de suivi a -1
+
+  static std::shared_ptr<const Scenario>
+  generate(const SimulationConfig &config, const RandomStreams &streams);
+};
+
+// Remplit `patients` (programmes puis urgences, ids = indices) en vidant une
+// PatientSource : c'est la generation utilisee par Simulation en mode batch.
+void generate_patients(const SimulationConfig &config, RandomStreams &streams,
+                       PatientTable &patients, PatientSource &source);
+void generate_patients(const SimulationConfig &config, RandomStreams &streams,
+                       PatientTable &patients);
+
+// Vrai si deux configurations produisent le meme flux de patients ; elles
+// peuvent alors differer par les ressources ou la politique.
+bool same_patient_flow(const SimulationConfig &a, const SimulationConfig &b);
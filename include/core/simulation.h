@@ -1,17 +1,48 @@
 #pragma once
 
-#include <deque>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <queue>
-#include <random>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "core/event_queue.h"
 #include "core/patient.h"
+#include "core/patient_source.h"
+#include "core/policies.h"
+#include "core/profiler.h"
+#include "core/ready_queue.h"
+#include "core/rng.h"
+#include "core/run_control.h"
+#include "core/statistics.h"
+#include "core/trace.h"
+#include "core/variates.h"
 
-enum class EventType { Arrival, SurgeryEnd, CleaningEnd, RecoveryEnd };
+// Compteurs internes du moteur (hors KPI metier), collectes pendant un run
+// si SimulationConfig::collect_stats. Tableaux indexes par EventType.
+struct EngineStats {
+  static constexpr std::size_t kEventTypes = 4;
 
-enum class SchedulingPolicy { Fifo, PriorityFirst, Balanced };
+  std::array<std::uint64_t, kEventTypes> events{}; // evenements traites
+  // Temps propre de chaque handle_* (horloge murale), hors appels a
+  // pick_next_patient : ceux-ci ne sont comptes que dans pick_nanoseconds.
+  std::array<std::uint64_t, kEventTypes> handler_nanoseconds{};
+  std::uint64_t picks = 0; // appels a pick_next_patient
+  std::uint64_t pick_nanoseconds = 0;
+  // File d'evenements : taille maximale et moyenne ponderee par le temps
+  // simule ; files d'attente bloc et reveil : longueurs maximales.
+  std::size_t max_event_queue = 0;
+  double mean_event_queue = 0.0;
+  std::size_t max_waiting_surgery = 0;
+  std::size_t max_waiting_recovery = 0;
+
+  std::uint64_t total_events() const;
+  // Cumul de plusieurs runs : sommes, maxima, et file moyenne ponderee par
+  // le nombre d'evenements de chaque run.
+  void merge(const EngineStats &other);
+};
 
 struct SimulationConfig {
   double horizon_hours = 8.0;
@@ -28,18 +59,23 @@ struct SimulationConfig {
   double mean_surgery_minutes_elective = 60.0;
   double mean_surgery_minutes_urgent = 50.0;
   double mean_recovery_minutes = 45.0;
+  // Coefficient de variation des durees (ecart-type = cv x moyenne, au
+  // moins 1 min) ; 0 : durees fixes egales aux moyennes.
+  double duration_cv = 0.25;
 
   SchedulingPolicy policy = SchedulingPolicy::PriorityFirst;
   bool trace_events = false;
+  // Mode flux (memoire bornee) : chaque classe de patients est generee une
+  // arrivee d'avance et les emplacements des patients sortis sont recycles.
+  // Memes resultats que le mode batch ; get_patients() ne contient alors que
+  // les emplacements (patients actifs ou recycles).
+  bool streaming = false;
+  // Compteurs du moteur (EngineStats) : instance instrumentee du moteur,
+  // sans aucun cout quand desactive.
+  bool collect_stats = false;
   unsigned int seed = 1337u;
 };
 
-struct Event {
-  double time = 0.0;
-  EventType type = EventType::Arrival;
-  int patient_id = -1;
-};
-
 struct SimulationReport {
   int patients_arrived = 0;
   int urgent_arrived = 0;
@@ -60,53 +96,187 @@ struct SimulationReport {
 
   int operations_delayed = 0;
   int operations_cancelled = 0;
+
+  // Vide sauf si config.collect_stats.
+  EngineStats engine;
+};
+
+// Etat courant du moteur, lisible entre deux pas d'un run incremental.
+struct SimulationState {
+  double clock = 0.0; // temps du dernier evenement traite (minutes)
+  int busy_operating_rooms = 0; // nettoyage compris
+  int busy_surgeons = 0;
+  int busy_recovery_beds = 0;
+  std::size_t waiting_surgery = 0;
+  std::size_t waiting_recovery = 0;
+  std::size_t pending_events = 0;
+  std::size_t resident_patients = 0; // lignes de get_patients()
+};
+
+// Ressources modifiables en cours de run (Simulation::set_capacity).
+struct ResourceCapacity {
+  int operating_rooms = 0;
+  int surgeon_count = 0;
+  int recovery_beds = 0;
 };
 
+const char *event_type_name(EventType type);
+
+struct Scenario;
+
 class Simulation {
 public:
+  // Les tirages viennent de RandomStreams::from_seed(config.seed).
   explicit Simulation(SimulationConfig config);
+  Simulation(SimulationConfig config, const RandomStreams &streams);
+  // Reconfigure le moteur pour un nouveau run en gardant la memoire deja
+  // allouee (patients, files), reservee d'avance sur l'effectif attendu :
+  // une fois la capacite atteinte, un run n'alloue plus rien.
+  void reset(SimulationConfig config);
+  void reset(SimulationConfig config, unsigned int seed);
+  void reset(SimulationConfig config, const RandomStreams &streams);
+  // Mode nombres aleatoires communs : les patients sont copies du scenario
+  // au lieu d'etre tires (nullptr pour revenir au tirage). Leve
+  // std::invalid_argument au run() si le flux du scenario ne correspond pas
+  // a la configuration.
+  void set_scenario(std::shared_ptr<const Scenario> scenario);
   SimulationReport run();
+
+  // Run incremental (mode temps reel) : start() prepare le run comme run(),
+  // step() traite un evenement, run_until(t) tous ceux de temps <= t. Une
+  // fois finished(), memes resultats que run(). Les compteurs du moteur
+  // (collect_stats), le profileur et le RunControl ne sont pas alimentes
+  // dans ce mode.
+  void start();
+  // Faux quand le run est termine (ou jamais demarre).
+  bool step();
+  void run_until(double t);
+  bool finished() const { return run_finished_; }
+  SimulationState state() const;
+
+  // Capacites courantes et changement a l'instant at (au plus tot le
+  // dernier evenement traite). Pendant un run incremental, les evenements
+  // jusqu'a at sont d'abord traites (run_until), puis les patients en
+  // attente sont servis aussitot ; une baisse n'interrompt aucune activite.
+  // Les taux d'occupation sont rapportes a la capacite integree sur le
+  // temps.
+  ResourceCapacity capacity() const;
+  void set_capacity(const ResourceCapacity &capacity, double at);
+  // Indicateurs courants, tenus a jour par les handlers : disponible a tout
+  // instant (y compris pendant un run) sans repasser sur les patients. En
+  // cours de run, les taux sont rapportes au temps ecoule (horloge).
+  SimulationReport report() const;
+  // Traces (config.trace_events) : les enregistrements types vont au puits
+  // s'il est defini (non possede), sinon ils sont formates pour log_sink,
+  // sinon affiches sur la sortie standard.
+  void set_trace_sink(TraceSink *sink) { trace_sink_ = sink; }
   void set_log_sink(std::function<void(const std::string &, double)> sink);
 
-  const std::vector<Patient> &get_patients() const { return patients_; }
+  const EngineStats &engine_stats() const { return stats_; }
+  // Profileur (non possede, nullptr pour l'arreter) : recoit les phases du
+  // run et, s'il le demande (event_detail), passe le run par l'instance
+  // instrumentee du moteur (spans et occupations des ressources).
+  void set_profiler(EngineProfiler *profiler) { profiler_ = profiler; }
+  // Progression et annulation (non possede, nullptr pour le retirer) : run()
+  // leve SimulationCancelled si l'annulation est demandee en cours de run.
+  void set_run_control(RunControl *control) { control_ = control; }
+
+  // Patients du dernier run, stockes en colonnes (ligne = emplacement).
+  const PatientTable &get_patients() const { return patients_; }
 
 private:
-  using EventQueue =
-      std::priority_queue<Event, std::vector<Event>,
-                          std::function<bool(const Event &, const Event &)>>;
+  using EventQueue = SimulationEventQueue;
 
+  void reserve_capacity();
   void seed_patients();
   void push_event(const Event &event);
 
+  // Mode flux : emplacements de patients et reference par evenement en
+  // attente (+1 tant que le patient n'est pas sorti du reveil).
+  void spawn_arrival(PatientType type);
+  int allocate_slot(const Patient &patient);
+  void release_slot(int slot);
+
+  // Coeur du moteur, instancie par politique d'ordonnancement et par mode
+  // d'instrumentation (EngineMode) ; run() choisit l'instance une fois.
+  template <class Policy> void run_with_policy();
+  template <class Policy, bool Trace> void run_with_mode();
+  template <class Policy, class Mode> void run_events();
+  template <class Policy, class Mode>
+  void dispatch_event(const Event &event, double now);
+  template <class Policy, class Mode>
   void handle_arrival(const Event &event, double now);
+  template <class Policy, class Mode>
   void handle_surgery_end(const Event &event, double now);
+  template <class Policy, class Mode>
   void handle_cleaning_end(const Event &event, double now);
+  template <class Policy, class Mode>
   void handle_recovery_end(const Event &event, double now);
 
-  void try_schedule_surgery(double now);
-  void try_start_recovery(double now);
+  // Run incremental : instance du moteur choisie une fois par start()
+  template <class Policy> void start_with_policy();
+  template <class Policy, class Mode> bool live_step();
+  template <class Mode> void live_reschedule(double now);
 
-  int pick_next_patient(double now);
+  void advance_clock(double now);
+  void finish_run();
+  template <class Mode> void try_schedule_surgery(double now);
+  template <class Mode> void try_start_recovery(double now);
 
-  double draw_positive_duration(double mean_minutes);
-  double draw_urgent_interarrival_minutes();
+  int pick_next_patient();
+  template <class Policy>
+  ReadyKey ready_key(int patient_id, std::uint64_t sequence) const;
 
-  void log_event(const std::string &message, double time);
+  template <class Mode>
+  void trace(TraceKind kind, int patient_id, double now,
+             double cleaning_minutes = 0.0) {
+    if constexpr (Mode::trace)
+      emit_trace(kind, patient_id, now, cleaning_minutes);
+  }
+  void emit_trace(TraceKind kind, int patient_id, double now,
+                  double cleaning_minutes);
 
   SimulationConfig config_;
-  std::function<bool(const Event &, const Event &)> event_compare_;
   EventQueue events_;
   std::function<void(const std::string &, double)> log_sink_;
-  std::vector<Patient> patients_;
-  std::vector<int> waiting_patients_; // patient ids waiting for OR
-  std::deque<int> recovery_waiting_;  // patient ids waiting for recovery bed
-  std::mt19937 rng_;
-  std::exponential_distribution<double> urgent_interarrival_;
+  TraceSink *trace_sink_ = nullptr;
+  EngineProfiler *profiler_ = nullptr;
+  RunControl *control_ = nullptr;
+  PatientTable patients_;
+  ReadyQueue waiting_patients_;       // patient ids waiting for OR
+  std::vector<int> recovery_waiting_; // patient ids waiting for recovery bed
+  std::size_t recovery_head_ = 0;     // premier patient en attente de lit
+  RandomStreams streams_;
+  PatientSource source_;
+  bool streaming_ = false; // mode flux actif pour ce run (hors scenario)
+  std::vector<int> free_slots_;
+  std::vector<int> slot_references_;
+  std::shared_ptr<const Scenario> scenario_;
   double horizon_minutes_ = 0.0;
+  EngineStats stats_;
+  bool (Simulation::*live_step_)() = nullptr; // nullptr : pas de run en cours
+  void (Simulation::*live_reschedule_)(double) = nullptr;
+  bool run_finished_ = false; // run() ou run incremental arrive au bout
+
+  // Accumulateurs en ligne : temps d'occupation integres entre evenements,
+  // attentes et sejours ajoutes quand ils se produisent.
+  double clock_ = 0.0;
   double operating_room_busy_minutes_ = 0.0;
   double surgeon_busy_minutes_ = 0.0;
-
   double recovery_busy_minutes_ = 0.0;
+  // Capacites integrees jusqu'au dernier changement (set_capacity)
+  double capacity_changed_at_ = 0.0;
+  double room_capacity_minutes_ = 0.0;
+  double surgeon_capacity_minutes_ = 0.0;
+  double bed_capacity_minutes_ = 0.0;
+  int patients_arrived_ = 0;
+  int urgent_arrived_ = 0;
+  int elective_arrived_ = 0;
+  int operations_delayed_ = 0;
+  RunningStat wait_to_surgery_;
+  RunningStat wait_to_recovery_;
+  RunningStat time_in_system_;
+
   int busy_operating_rooms_ = 0;
   int busy_recovery_beds_ = 0;
   int busy_surgeons_ = 0;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Accumulateur de Welford : moyenne et variance en une passe, fusionnable
+// (formule de Chan) pour les reductions paralleles.
+struct RunningStat {
+  std::int64_t count = 0;
+  double mean = 0.0;
+  double m2 = 0.0; // somme des carres des ecarts a la moyenne
+  double min = 0.0;
+  double max = 0.0;
+
+  void add(double value);
+  void merge(const RunningStat &other);
+
+  double variance() const; // variance d'echantillon (n - 1)
+  double stddev() const;
+  // Demi-largeur de l'intervalle de confiance a 95 % sur la moyenne
+  // (loi de Student a n - 1 degres de liberte).
+  double ci95_half_width() const;
+};
+
+// Quantile a 97,5 % de la loi de Student (intervalle bilateral a 95 %).
+double student_t_975(std::int64_t degrees_of_freedom);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "core/replication.h"
+#include "core/simulation.h"
+
+// Champs numeriques de SimulationConfig accessibles par leur nom (ceux des
+// options CLI) : operating_rooms, recovery_beds, surgeon_count,
+// elective_patients, horizon_hours, elective_window_hours,
+// urgent_rate_per_hour, cleaning_time_minutes,
+// mean_surgery_minutes_elective, mean_surgery_minutes_urgent,
+// mean_recovery_minutes, duration_cv et policy (0 fifo, 1 priorite,
+// 2 equilibre).
+// Leve std::invalid_argument si le champ est inconnu ou si la valeur d'un
+// champ entier n'est pas entiere.
+void set_config_field(SimulationConfig &config, const std::string &field,
+                      double value);
+double config_field(const SimulationConfig &config, const std::string &field);
+
+// Axe de balayage : un champ et la liste de ses valeurs.
+struct SweepAxis {
+  std::string field;
+  std::vector<double> values;
+
+  // Valeurs first, first + step, ... jusqu'a last inclus (step > 0).
+  static SweepAxis range(std::string field, double first, double last,
+                         double step);
+  // Syntaxe CLI : "champ=debut:fin:pas" ou "champ=v1,v2,...". Leve
+  // std::invalid_argument si la specification est mal formee.
+  static SweepAxis parse(const std::string &spec);
+};
+
+enum class SweepMode {
+  Grid, // produit cartesien des axes (dernier axe le plus rapide)
+  List  // point i = i-eme valeur de chaque axe (axes de meme longueur)
+};
+
+struct SweepDefinition {
+  SimulationConfig base;
+  std::vector<SweepAxis> axes;
+  SweepMode mode = SweepMode::Grid;
+  int replications = 10;
+  // Budget memoire par replication en octets (0 : sans limite) ; un
+  // depassement arrete le balayage (MemoryBudgetExceeded).
+  std::size_t memory_budget = 0;
+  // Remplit SweepPointResult::memory (appmed_alloc_hooks requis).
+  bool track_memory = false;
+
+  // Leve std::invalid_argument si la definition est incoherente.
+  void validate() const;
+  std::size_t point_count() const;
+  std::vector<double> point_values(std::size_t point) const;
+  SimulationConfig point_config(std::size_t point) const;
+  // Empreinte (16 chiffres hexadecimaux) de tout ce qui determine les
+  // resultats : configuration de base, graine, axes, mode et replications.
+  // Ecrite en tete des sorties, elle interdit de reprendre un fichier produit
+  // par un autre balayage.
+  std::string fingerprint() const;
+};
+
+struct SweepPointResult {
+  std::size_t point = 0;
+  std::vector<double> values; // une valeur par axe
+  ReplicationSummary summary;
+  AllocationStats memory; // cumul des replications (track_memory)
+};
+
+// Recoit les points au fur et a mesure qu'ils sont termines (ordre de fin,
+// pas ordre des indices). Les appels sont serialises par SweepRunner.
+class SweepSink {
+public:
+  virtual ~SweepSink() = default;
+  virtual void write_point(const SweepPointResult &result) = 0;
+};
+
+// Balayage : chaque couple (point, replication) est une tache distribuee
+// par vol de travail sur un pool de threads (un moteur reutilise par
+// thread). La replication r de chaque point tire ses nombres du r-ieme flux
+// de ReplicationStreams(base.seed) : nombres aleatoires communs entre points,
+// resultats identiques quel que soit le nombre de threads. Un point est
+// agrege (dans l'ordre des replications) et emis des que sa derniere
+// replication se termine.
+class SweepRunner {
+public:
+  // threads <= 0 : autant que de coeurs disponibles.
+  explicit SweepRunner(SweepDefinition definition, int threads = 0);
+
+  // Les points de `completed` (reprise d'un balayage interrompu) sont
+  // ignores. Retourne le nombre de points calcules.
+  std::size_t run(SweepSink &sink,
+                  const std::vector<std::size_t> &completed = {});
+
+  const SweepDefinition &definition() const { return definition_; }
+  int threads() const { return threads_; }
+
+private:
+  SweepDefinition definition_;
+  int threads_ = 1;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/patient.h"
+
+// Trace desactivee a la compilation (-DAPPMED_DISABLE_TRACE) : les appels
+// de trace du moteur disparaissent entierement.
+#if defined(APPMED_DISABLE_TRACE)
+inline constexpr bool kTraceEnabled = false;
+#else
+inline constexpr bool kTraceEnabled = true;
+#endif
+
+enum class TraceKind : std::uint8_t {
+  Arrival,
+  SurgeryStart,
+  SurgeryEnd,
+  CleaningEnd,
+  RecoveryStart,
+  RecoveryEnd
+};
+
+// Evenement de trace type : aucun texte n'est construit par le moteur, le
+// consommateur formate (ou non) a la lecture.
+struct TraceRecord {
+  double time = 0.0;
+  TraceKind kind = TraceKind::Arrival;
+  PatientType patient_type = PatientType::Elective;
+  int patient_id = -1;
+  // Etat des ressources juste apres l'evenement
+  int busy_operating_rooms = 0;
+  int busy_surgeons = 0;
+  int busy_recovery_beds = 0;
+  int surgeon_count = 0;
+  double cleaning_minutes = 0.0; // duree du nettoyage lance (SurgeryEnd)
+};
+
+class TraceSink {
+public:
+  virtual ~TraceSink() = default;
+  virtual void record(const TraceRecord &record) = 0;
+};
+
+// Puits qui conserve les enregistrements tels quels.
+class TraceBuffer : public TraceSink {
+public:
+  void record(const TraceRecord &record) override {
+    records.push_back(record);
+  }
+
+  std::vector<TraceRecord> records;
+};
+
+// Texte historique du journal ("Patient 3 arrive (urgence)", ...).
+std::string format_trace_message(const TraceRecord &record);
+// Minutes avec une decimale, comme dans le journal.
+std::string format_minutes(double minutes);
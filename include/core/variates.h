@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/rng.h"
+
+// Tirages par lots : chaque noyau remplit un tableau en quelques passes
+// sans branchement (uniformes, puis transformation), que le compilateur
+// peut vectoriser, au lieu d'un objet distribution par tirage.
+
+// Uniformes dans l'intervalle ouvert (0, 1) : log(u) est toujours fini.
+void fill_uniform_open(Xoshiro256PlusPlus &rng, double *out, std::size_t n);
+
+// Normales centrees reduites par Box-Muller (une paire par couple
+// d'uniformes ; le dernier tirage d'un n impair est perdu).
+void fill_standard_normal(Xoshiro256PlusPlus &rng, double *out, std::size_t n);
+
+// Exponentielles de taux `rate` par inversion : -log(u) / rate.
+void fill_exponential(Xoshiro256PlusPlus &rng, double rate, double *out,
+                      std::size_t n);
+
+// Normales N(mean, stddev) tronquees a > lower : les valeurs rejetees sont
+// retirees (16 essais au plus, comme l'ancien tirage unitaire) puis
+// remplacees par `fallback`.
+void fill_truncated_normal(Xoshiro256PlusPlus &rng, double mean,
+                           double stddev, double lower, double fallback,
+                           double *out, std::size_t n);
+
+// Suites de tirages produites par blocs de taille fixe puis consommees une a
+// une : la suite obtenue ne depend pas du rythme de lecture (tout d'un coup
+// en mode batch, au fil des arrivees en mode flux). Les tampons sont gardes
+// d'un run a l'autre.
+class TruncatedNormalSampler {
+public:
+  void reset(double mean, double stddev, double lower, double fallback,
+             std::size_t chunk);
+  double next(Xoshiro256PlusPlus &rng) {
+    if (next_ == buffer_.size())
+      refill(rng);
+    return buffer_[next_++];
+  }
+
+private:
+  void refill(Xoshiro256PlusPlus &rng);
+
+  std::vector<double> buffer_;
+  std::size_t next_ = 0;
+  std::size_t chunk_ = 1;
+  double mean_ = 0.0;
+  double stddev_ = 1.0;
+  double lower_ = 0.0;
+  double fallback_ = 0.0;
+};
+
+class ExponentialSampler {
+public:
+  void reset(double rate, std::size_t chunk);
+  double next(Xoshiro256PlusPlus &rng) {
+    if (next_ == buffer_.size())
+      refill(rng);
+    return buffer_[next_++];
+  }
+
+private:
+  void refill(Xoshiro256PlusPlus &rng);
+
+  std::vector<double> buffer_;
+  std::size_t next_ = 0;
+  std::size_t chunk_ = 1;
+  double rate_ = 1.0;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Distribue les indices [0, count) sur `threads` threads par vol de travail :
+// chaque thread consomme sa plage d'indices par l'avant ; un thread a court
+// de travail vole la moitie arriere de la plage d'un autre. Les indices
+// voisins restent sur le meme thread (localite), la charge s'equilibre meme
+// si les durees des taches sont tres inegales. Job : (thread, indice).
+template <typename Job>
+void parallel_for_stealing(std::size_t count, int threads, Job &&job) {
+  struct Range {
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+  };
+
+  const std::size_t used = std::max<std::size_t>(
+      1, std::min<std::size_t>(static_cast<std::size_t>(std::max(1, threads)),
+                               count));
+  std::unique_ptr<Range[]> ranges(new Range[used]);
+  for (std::size_t w = 0; w < used; ++w) {
+    ranges[w].begin = count * w / used;
+    ranges[w].end = count * (w + 1) / used;
+  }
+
+  std::atomic<bool> stop{false};
+  std::exception_ptr failure;
+  std::mutex failure_mutex;
+
+  auto take_local = [&](std::size_t w, std::size_t &index) {
+    std::lock_guard<std::mutex> lock(ranges[w].mutex);
+    if (ranges[w].begin == ranges[w].end)
+      return false;
+    index = ranges[w].begin++;
+    return true;
+  };
+
+  auto steal = [&](std::size_t w) {
+    for (std::size_t k = 1; k < used; ++k) {
+      Range &victim = ranges[(w + k) % used];
+      std::size_t begin = 0;
+      std::size_t end = 0;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        const std::size_t left = victim.end - victim.begin;
+        if (left == 0)
+          continue;
+        begin = victim.end - (left + 1) / 2;
+        end = victim.end;
+        victim.end = begin;
+      }
+      std::lock_guard<std::mutex> lock(ranges[w].mutex);
+      ranges[w].begin = begin;
+      ranges[w].end = end;
+      return true;
+    }
+    return false;
+  };
+
+  auto worker = [&](std::size_t w) {
+    try {
+      std::size_t index = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (take_local(w, index))
+          job(static_cast<int>(w), index);
+        else if (!steal(w))
+          return; // plus rien nulle part
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(failure_mutex);
+      if (!failure)
+        failure = std::current_exception();
+      stop = true; // les autres threads s'arretent a la tache suivante
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(used - 1);
+  for (std::size_t w = 1; w < used; ++w)
+    pool.emplace_back(worker, w);
+  worker(0);
+  for (auto &thread : pool)
+    thread.join();
+
+  if (failure)
+    std::rethrow_exception(failure);
+}
@@ -9,8 +9,10 @@
 #include <QSpinBox>
 #include <QString>
 #include <QWidget>
+#include <memory>
 
 #include "core/simulation.h"
+#include "ui/simulation_task.h"
 
 class SimulationWindow : public QWidget {
   Q_OBJECT
@@ -32,7 +34,9 @@ private:
 
   void exporter_csv();
 
+  // Lance le run hors du thread GUI ; le rapport s'affiche quand il est prêt
   void lancer_simulation();
+  void annuler_calcul();
   SimulationConfig lire_config() const;
   void afficher_rapport(const SimulationConfig &config,
                         const SimulationReport &report);
@@ -68,7 +72,9 @@ private:
 
   SimulationReport dernier_rapport_;
   SimulationConfig dernier_config_;
-  std::vector<Patient> derniers_patients_;
+  // Moteur du dernier run (ses patients servent à l'export, sans copie)
+  std::unique_ptr<Simulation> derniere_simulation_;
+  SimulationTask *calcul_;
 
   bool mode_temps_reel_ = false;
 };
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <cstdint>
+#include <vector>
+
+#include "core/patient.h"
+#include "core/replay.h"
+
+// Modèle du tableau des patients (mode temps réel) : lit directement les
+// colonnes du scénario et l'état courant du rejeu. Aucun item par cellule,
+// les cellules ne sont calculées que lorsque la vue les affiche.
+class PatientTableModel : public QAbstractTableModel {
+  Q_OBJECT
+public:
+  enum Colonne { ColId, ColType, ColArrivee, ColEtat, ColAttente, NbColonnes };
+  // Valeur brute d'une cellule (nombre ou état), pour le tri
+  static constexpr int RoleValeur = Qt::UserRole + 1;
+
+  explicit PatientTableModel(QObject *parent = nullptr);
+
+  // Nouveau scénario. La table et le rejeu restent la propriété de
+  // l'appelant et doivent vivre aussi longtemps que le modèle.
+  void definir_scenario(const PatientTable *patients,
+                        const ReplayCursor *replay);
+  // Après advance()/seek() du rejeu : dataChanged pour les lignes dont
+  // l'état a changé et pour l'attente des patients en attente, par plages
+  // de lignes contiguës.
+  void notifier_rejeu(double temps_minutes);
+
+  PatientType type(int ligne) const { return patients_->type[ligne]; }
+  ReplayState etat(int ligne) const { return replay_->state(ligne); }
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+private:
+  // Attente affichée (minutes), négative si le patient n'est pas arrivé
+  double attente(int ligne) const;
+
+  const PatientTable *patients_ = nullptr;
+  const ReplayCursor *replay_ = nullptr;
+  double temps_ = 0.0;
+  std::vector<std::uint32_t> lignes_; // tampon réutilisé par notifier_rejeu
+};
+
+// Tri et filtres au-dessus du modèle : le proxy ne garde que des
+// correspondances d'indices, jamais de copie des patients.
+class PatientFilterModel : public QSortFilterProxyModel {
+  Q_OBJECT
+public:
+  enum class Filtre { Tous, Urgences, EnAttente };
+
+  explicit PatientFilterModel(QObject *parent = nullptr);
+  void definir_filtre(Filtre filtre);
+
+protected:
+  bool filterAcceptsRow(int source_row,
+                        const QModelIndex &source_parent) const override;
+
+private:
+  Filtre filtre_ = Filtre::Tous;
+};
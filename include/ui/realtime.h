@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QCheckBox>
 #include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QFileDialog>
@@ -9,18 +10,20 @@
 #include <QPlainTextEdit>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QSlider>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTableView>
+#include <QTemporaryFile>
 #include <QTimer>
 #include <QWidget>
+#include <memory>
 #include <vector>
 
+#include "core/replay.h"
 #include "core/simulation.h"
-
-struct EventLog {
-  double time;
-  std::string message;
-};
+#include "core/trace.h"
+#include "ui/patient_model.h"
+#include "ui/simulation_task.h"
 
 class RealTimeWindow : public QWidget {
   Q_OBJECT
@@ -35,6 +38,7 @@ private slots:
   void mettre_en_pause();
   void arreter_simulation();
   void tic_horloge(); // Appelé par le timer à chaque "tick"
+  void aller_a(int minute); // Saut dans la chronologie (curseur)
 
   void terminer_simulation();
   void exporter_logs();
@@ -46,10 +50,27 @@ private:
   QFrame *creer_kpi_widget(const QString &titre, QLabel *&label_valeur,
                            const QString &couleur);
 
+  SimulationConfig lire_config() const;
+  // Lance le calcul du scénario hors du thread GUI ; la lecture démarre
+  // quand il est prêt.
   void precalculer_scenario();
+  // Moteur en direct : chaque tic fait avancer le moteur lui-même
+  // (run_until), sans précalcul ni rejeu.
+  void demarrer_direct();
+  void tic_direct();
+  void changer_capacite();
+  // Scénario calculé (déjà déplacé dans la fenêtre) : tableau, chronologie
+  void installer_scenario();
+  void lancer_lecture();
+  // Signale à la vue les lignes changées depuis le tic précédent (et
+  // l'attente des patients en attente) ; la vue ne redessine que les
+  // lignes visibles.
   void mettre_a_jour_tableau_patients();
 
   void mettre_a_jour_kpi();
+  void afficher_horloge();
+  // Journal repositionné sur l'instant courant (dernières lignes seulement)
+  void reconstruire_console();
   void basculer_edition_inputs(bool actif);
 
   void afficher_rapport_fin();
@@ -81,20 +102,36 @@ private:
 
   // Affichage
   QProgressBar *barre_progression_;
+  QSlider *curseur_temps_;
   QLabel *label_temps_;
   QPlainTextEdit *log_console_;
 
-  QTableWidget *table_patients_;
+  QTableView *table_patients_;
+  PatientTableModel *modele_patients_;
+  PatientFilterModel *proxy_patients_;
+  QComboBox *filtre_patients_;
 
   // Logique temporelle
   QTimer *timer_;
+  SimulationTask *calcul_; // précalcul du scénario (thread du pool)
+
+  // Moteur en direct (nullptr en mode rejeu)
+  QCheckBox *mode_direct_;
+  std::unique_ptr<Simulation> direct_;
+  TraceBuffer trace_direct_; // évènements du dernier tic
+  // Journal exporté du mode direct, écrit au fil des tics : la mémoire ne
+  // dépend pas de la durée du run
+  std::unique_ptr<QTemporaryFile> journal_direct_;
   double temps_actuel_minutes_ = 0.0;
   double horizon_minutes_ = 480.0; // 8 heures par défaut
   double fin_effective_minutes_ = 480.0;
   bool en_cours_ = false;
+  bool scenario_pret_ = false; // scénario précalculé, chronologie navigable
 
-  std::vector<EventLog> events_queue_;
+  std::vector<TraceRecord> events_queue_; // rejeu, formatés à l'affichage
   size_t current_event_index_ = 0;
 
-  std::vector<Patient> patients_snapshots_;
+  PatientTable patients_snapshots_;
+  // Transitions d'etat du scenario, appliquees au fil des tics
+  ReplayCursor replay_;
 };
\ No newline at end of file
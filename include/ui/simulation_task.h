@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/run_control.h"
+
+// Exécute un calcul (Simulation::run() et sa préparation) sur le pool de
+// QtConcurrent, hors du thread GUI. Un seul calcul courant par tâche : en
+// lancer un nouveau annule le précédent, dont le résultat est ignoré.
+class SimulationTask : public QObject {
+  Q_OBJECT
+public:
+  // travail : sur un thread du pool, doit passer le RunControl au moteur
+  // (Simulation::set_run_control). fin : sur le thread GUI, seulement si le
+  // calcul n'a été ni annulé ni remplacé.
+  using Travail = std::function<void(RunControl &)>;
+  using Fin = std::function<void()>;
+
+  explicit SimulationTask(QObject *parent = nullptr);
+  // Annule les calculs en cours et attend leur arrêt
+  ~SimulationTask() override;
+
+  void lancer(Travail travail, Fin fin);
+  // Annulation coopérative : le moteur s'arrête au prochain point de
+  // contrôle, aucun signal n'est émis pour ce calcul.
+  void annuler();
+  bool en_cours() const { return courant_ != nullptr; }
+
+signals:
+  // Temps simulé atteint par le calcul courant (minutes)
+  void progression(double minutes, double horizon);
+  void echec(const QString &message);
+
+private:
+  struct Execution {
+    RunControl control;
+  };
+
+  std::shared_ptr<Execution> courant_;
+  std::vector<QFuture<void>> calculs_; // en cours ou annulés, pas encore finis
+};
@@ -0,0 +1,109 @@
+// Crochets operator new/delete de la cible appmed_alloc_hooks (bibliotheque
+// objet : liee, elle remplace les operateurs globaux de l'executable).
+// Chaque bloc porte un en-tete avec sa taille, pour decompter la memoire
+// liberee meme sans delete dimensionne.
+
+#include "core/alloc_tracking.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+struct HooksInstaller {
+  HooksInstaller() { alloc_tracking_detail::mark_hooks_installed(); }
+} g_installer;
+
+std::size_t header_for(std::size_t alignment) {
+  return alignment > kHeader ? alignment : kHeader;
+}
+
+void *allocate(std::size_t size, std::size_t alignment) {
+  alloc_tracking_detail::on_allocate(size); // peut lever (budget)
+  const std::size_t header = header_for(alignment);
+  const std::size_t total = size + header;
+  void *base = alignment > kHeader
+                   ? std::aligned_alloc(alignment, (total + alignment - 1) /
+                                                       alignment * alignment)
+                   : std::malloc(total);
+  if (!base) {
+    alloc_tracking_detail::on_deallocate(size);
+    throw std::bad_alloc();
+  }
+  *static_cast<std::size_t *>(base) = size;
+  return static_cast<char *>(base) + header;
+}
+
+void release(void *p, std::size_t alignment) noexcept {
+  if (!p)
+    return;
+  void *base = static_cast<char *>(p) - header_for(alignment);
+  alloc_tracking_detail::on_deallocate(*static_cast<std::size_t *>(base));
+  std::free(base);
+}
+
+void *allocate_nothrow(std::size_t size, std::size_t alignment) noexcept {
+  try {
+    return allocate(size, alignment);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size, kHeader); }
+void *operator new[](std::size_t size) { return allocate(size, kHeader); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate_nothrow(size, kHeader);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return allocate_nothrow(size, kHeader);
+}
+void *operator new(std::size_t size, std::align_val_t align) {
+  return allocate(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+  return allocate(size, static_cast<std::size_t>(align));
+}
+void *operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return allocate_nothrow(size, static_cast<std::size_t>(align));
+}
+void *operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return allocate_nothrow(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *p) noexcept { release(p, kHeader); }
+void operator delete[](void *p) noexcept { release(p, kHeader); }
+void operator delete(void *p, std::size_t) noexcept { release(p, kHeader); }
+void operator delete[](void *p, std::size_t) noexcept { release(p, kHeader); }
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  release(p, kHeader);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  release(p, kHeader);
+}
+void operator delete(void *p, std::align_val_t align) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void *p, std::align_val_t align) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
+void operator delete(void *p, std::size_t, std::align_val_t align) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void *p, std::size_t, std::align_val_t align) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
+void operator delete(void *p, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
+void operator delete[](void *p, std::align_val_t align,
+                       const std::nothrow_t &) noexcept {
+  release(p, static_cast<std::size_t>(align));
+}
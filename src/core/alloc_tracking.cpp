@@ -0,0 +1,89 @@
+#include "core/alloc_tracking.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+std::atomic<bool> g_hooks_installed{false};
+// Portee la plus interne du thread (pointeur brut : aucune initialisation
+// dynamique, utilisable des le premier operator new du thread).
+thread_local AllocationScope *t_current_scope = nullptr;
+
+} // namespace
+
+struct AllocationScopeAccess {
+  static AllocationScope *parent(AllocationScope *scope) {
+    return scope->parent_;
+  }
+  static AllocationStats &stats(AllocationScope *scope) {
+    return scope->stats_;
+  }
+};
+
+void AllocationStats::merge(const AllocationStats &other) {
+  allocations += other.allocations;
+  deallocations += other.deallocations;
+  bytes += other.bytes;
+  live_bytes += other.live_bytes;
+  peak_live_bytes = std::max(peak_live_bytes, other.peak_live_bytes);
+}
+
+MemoryBudgetExceeded::MemoryBudgetExceeded(std::size_t requested,
+                                           std::int64_t live_bytes,
+                                           std::size_t budget)
+    : requested_(requested), live_bytes_(live_bytes), budget_(budget) {
+  std::snprintf(message_, sizeof(message_),
+                "Budget memoire depasse : %zu octets demandes, %lld en "
+                "cours, budget %zu",
+                requested, static_cast<long long>(live_bytes), budget);
+}
+
+bool allocation_tracking_available() {
+  return g_hooks_installed.load(std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope(std::size_t budget_bytes)
+    : parent_(t_current_scope), budget_(budget_bytes) {
+  t_current_scope = this;
+}
+
+AllocationScope::~AllocationScope() { t_current_scope = parent_; }
+
+namespace alloc_tracking_detail {
+
+void on_allocate(std::size_t bytes) {
+  const std::int64_t size = static_cast<std::int64_t>(bytes);
+  for (AllocationScope *scope = t_current_scope; scope;
+       scope = AllocationScopeAccess::parent(scope)) {
+    const AllocationStats &stats = AllocationScopeAccess::stats(scope);
+    if (scope->budget() > 0 &&
+        stats.live_bytes + size > static_cast<std::int64_t>(scope->budget())) {
+      throw MemoryBudgetExceeded(bytes, stats.live_bytes, scope->budget());
+    }
+  }
+  for (AllocationScope *scope = t_current_scope; scope;
+       scope = AllocationScopeAccess::parent(scope)) {
+    AllocationStats &stats = AllocationScopeAccess::stats(scope);
+    ++stats.allocations;
+    stats.bytes += bytes;
+    stats.live_bytes += size;
+    stats.peak_live_bytes = std::max(stats.peak_live_bytes, stats.live_bytes);
+  }
+}
+
+void on_deallocate(std::size_t bytes) noexcept {
+  for (AllocationScope *scope = t_current_scope; scope;
+       scope = AllocationScopeAccess::parent(scope)) {
+    AllocationStats &stats = AllocationScopeAccess::stats(scope);
+    ++stats.deallocations;
+    stats.live_bytes -= static_cast<std::int64_t>(bytes);
+  }
+}
+
+void mark_hooks_installed() noexcept {
+  g_hooks_installed.store(true, std::memory_order_relaxed);
+}
+
+} // namespace alloc_tracking_detail
@@ -1,5 +1,7 @@
 #include "core/patient.h"
 
+#include <algorithm>
+
 Patient::Patient(int id, PatientType type, double arrival)
     : id(id), type(type), arrival_time(arrival) 
 {
@@ -14,4 +16,90 @@ bool Patient::is_urgent() const {
 // Vérifie si le patient a fini son parcours (sortie de réveil)
 bool Patient::is_completed() const {
     return end_recovery_time >= 0.0;
-}
\ No newline at end of file
+}
+
+void PatientTable::clear() {
+    id.clear();
+    type.clear();
+    arrival_time.clear();
+    surgery_duration.clear();
+    recovery_duration.clear();
+    start_surgery_time.clear();
+    end_surgery_time.clear();
+    start_recovery_time.clear();
+    end_recovery_time.clear();
+}
+
+void PatientTable::reserve(std::size_t capacity) {
+    id.reserve(capacity);
+    type.reserve(capacity);
+    arrival_time.reserve(capacity);
+    surgery_duration.reserve(capacity);
+    recovery_duration.reserve(capacity);
+    start_surgery_time.reserve(capacity);
+    end_surgery_time.reserve(capacity);
+    start_recovery_time.reserve(capacity);
+    end_recovery_time.reserve(capacity);
+}
+
+void PatientTable::push_back(const Patient &p) {
+    id.push_back(p.id);
+    type.push_back(p.type);
+    arrival_time.push_back(static_cast<patient_time_t>(p.arrival_time));
+    surgery_duration.push_back(static_cast<patient_time_t>(p.surgery_duration));
+    recovery_duration.push_back(
+        static_cast<patient_time_t>(p.recovery_duration));
+    start_surgery_time.push_back(
+        static_cast<patient_time_t>(p.start_surgery_time));
+    end_surgery_time.push_back(static_cast<patient_time_t>(p.end_surgery_time));
+    start_recovery_time.push_back(
+        static_cast<patient_time_t>(p.start_recovery_time));
+    end_recovery_time.push_back(
+        static_cast<patient_time_t>(p.end_recovery_time));
+}
+
+void PatientTable::set_row(std::size_t index, const Patient &p) {
+    id[index] = p.id;
+    type[index] = p.type;
+    arrival_time[index] = static_cast<patient_time_t>(p.arrival_time);
+    surgery_duration[index] = static_cast<patient_time_t>(p.surgery_duration);
+    recovery_duration[index] =
+        static_cast<patient_time_t>(p.recovery_duration);
+    start_surgery_time[index] =
+        static_cast<patient_time_t>(p.start_surgery_time);
+    end_surgery_time[index] = static_cast<patient_time_t>(p.end_surgery_time);
+    start_recovery_time[index] =
+        static_cast<patient_time_t>(p.start_recovery_time);
+    end_recovery_time[index] =
+        static_cast<patient_time_t>(p.end_recovery_time);
+}
+
+PatientRef::operator Patient() const {
+    Patient p(id, type, arrival_time);
+    p.surgery_duration = surgery_duration;
+    p.recovery_duration = recovery_duration;
+    p.start_surgery_time = start_surgery_time;
+    p.end_surgery_time = end_surgery_time;
+    p.start_recovery_time = start_recovery_time;
+    p.end_recovery_time = end_recovery_time;
+    return p;
+}
+
+PatientTable PatientTable::sorted_by_arrival() const {
+    std::vector<std::size_t> order(size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [this](std::size_t a, std::size_t b) {
+                         return arrival_time[a] < arrival_time[b];
+                     });
+    PatientTable sorted;
+    sorted.reserve(size());
+    for (std::size_t i : order)
+        sorted.push_back(Patient((*this)[i]));
+    return sorted;
+}
+
+std::vector<Patient> PatientTable::to_vector() const {
+    return std::vector<Patient>(begin(), end());
+}
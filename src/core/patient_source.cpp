@@ -0,0 +1,79 @@
+#include "core/patient_source.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/simulation.h"
+
+namespace {
+
+// Durees N(mean, max(1, cv x mean)) tronquees a > 1 minute ; cv = 0 :
+// duree fixe.
+void reset_durations(TruncatedNormalSampler &sampler, double mean_minutes,
+                     double cv, std::size_t chunk) {
+  const double stddev = cv > 0.0 ? std::max(1.0, mean_minutes * cv) : 0.0;
+  sampler.reset(mean_minutes, stddev, 1.0, mean_minutes, chunk);
+}
+
+} // namespace
+
+void PatientSource::reset(const SimulationConfig &config) {
+  horizon_minutes_ = config.horizon_hours * 60.0;
+  elective_window_minutes_ =
+      std::max(0.1, config.elective_window_hours) * 60.0;
+  elective_count_ = std::max(0, config.elective_patients);
+  electives_emitted_ = 0;
+  urgents_emitted_ = 0;
+  urgent_clock_ = 0.0;
+
+  const std::size_t elective_chunk = std::min(
+      kMaxChunk, static_cast<std::size_t>(std::max(1, elective_count_)));
+  const double cv = config.duration_cv;
+  reset_durations(elective_surgery_, config.mean_surgery_minutes_elective, cv,
+                  elective_chunk);
+  reset_durations(elective_recovery_, config.mean_recovery_minutes, cv,
+                  elective_chunk);
+
+  // Urgences (processus de Poisson) : inter-arrivees par blocs dimensionnes
+  // sur l'effectif attendu.
+  urgents_exhausted_ = !(config.urgent_rate_per_hour > 0.0);
+  const double rate_per_minute = config.urgent_rate_per_hour / 60.0;
+  const double expected = std::max(0.0, rate_per_minute * horizon_minutes_);
+  const std::size_t block = std::min(
+      kMaxChunk, static_cast<std::size_t>(std::max(
+                     16.0, expected + 4.0 * std::sqrt(expected) + 1.0)));
+  if (!urgents_exhausted_)
+    urgent_gaps_.reset(rate_per_minute, block);
+  reset_durations(urgent_surgery_, config.mean_surgery_minutes_urgent, cv,
+                  block);
+  reset_durations(urgent_recovery_, config.mean_recovery_minutes, cv, block);
+}
+
+bool PatientSource::next_elective(RandomStreams &streams, Patient &out) {
+  if (electives_emitted_ >= elective_count_)
+    return false;
+  const int index = electives_emitted_++;
+  // Arrivees regulieres sur la fenetre des programmes
+  const double position =
+      (static_cast<double>(index) + 0.5) / static_cast<double>(elective_count_);
+  out = Patient(index, PatientType::Elective,
+                position * elective_window_minutes_);
+  out.surgery_duration = elective_surgery_.next(streams.elective_surgery);
+  out.recovery_duration = elective_recovery_.next(streams.elective_recovery);
+  return true;
+}
+
+bool PatientSource::next_urgent(RandomStreams &streams, Patient &out) {
+  if (urgents_exhausted_)
+    return false;
+  urgent_clock_ += urgent_gaps_.next(streams.urgent_arrivals);
+  if (urgent_clock_ > horizon_minutes_) {
+    urgents_exhausted_ = true;
+    return false;
+  }
+  out = Patient(elective_count_ + urgents_emitted_++, PatientType::Urgent,
+                urgent_clock_);
+  out.surgery_duration = urgent_surgery_.next(streams.urgent_surgery);
+  out.recovery_duration = urgent_recovery_.next(streams.urgent_recovery);
+  return true;
+}
@@ -0,0 +1,162 @@
+#include "core/perf_counters.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+struct CounterSpec {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+// Dans l'ordre de HardwareCounter.
+const CounterSpec kCounterSpecs[kHardwareCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+int open_counter(const CounterSpec &spec) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Temps actif et temps compte : mise a l'echelle si multiplexe
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Thread courant, tout CPU, compteur independant (pas de groupe : un
+  // compteur absent n'empeche pas les autres).
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+#endif
+
+} // namespace
+
+PerfProfiler::PerfProfiler() {
+#if defined(__linux__)
+  for (std::size_t c = 0; c < kHardwareCounters; ++c) {
+    fds_[c] = open_counter(kCounterSpecs[c]);
+    if (fds_[c] < 0 && error_.empty()) {
+      error_ = std::string("perf_event_open (") +
+               counter_name(static_cast<HardwareCounter>(c)) +
+               ") : " + std::strerror(errno);
+    }
+  }
+  if (available())
+    error_.clear();
+#else
+  error_ = "compteurs materiels disponibles sous Linux uniquement";
+#endif
+}
+
+PerfProfiler::~PerfProfiler() {
+#if defined(__linux__)
+  for (int fd : fds_) {
+    if (fd >= 0)
+      close(fd);
+  }
+#endif
+}
+
+bool PerfProfiler::available() const {
+  for (int fd : fds_) {
+    if (fd >= 0)
+      return true;
+  }
+  return false;
+}
+
+bool PerfProfiler::counter_available(HardwareCounter counter) const {
+  return fds_[static_cast<std::size_t>(counter)] >= 0;
+}
+
+void PerfProfiler::read_all(std::array<Reading, kHardwareCounters> &out) const {
+  for (std::size_t c = 0; c < kHardwareCounters; ++c) {
+    out[c] = Reading{};
+#if defined(__linux__)
+    std::uint64_t raw[3]; // value, time_enabled, time_running
+    if (fds_[c] >= 0 && read(fds_[c], raw, sizeof(raw)) == sizeof(raw))
+      out[c] = Reading{raw[0], raw[1], raw[2]};
+#endif
+  }
+}
+
+void PerfProfiler::enter(EnginePhase) {
+  started_time_ = std::chrono::steady_clock::now();
+  read_all(started_);
+}
+
+void PerfProfiler::leave(EnginePhase phase) {
+  std::array<Reading, kHardwareCounters> now;
+  read_all(now);
+  const auto finished = std::chrono::steady_clock::now();
+  PhaseCounters &counters = phases_[static_cast<std::size_t>(phase)];
+  for (std::size_t c = 0; c < kHardwareCounters; ++c) {
+    const std::uint64_t value = now[c].value - started_[c].value;
+    const std::uint64_t enabled = now[c].enabled - started_[c].enabled;
+    const std::uint64_t running = now[c].running - started_[c].running;
+    // Compteur partage avec d'autres pendant la phase : extrapolation au
+    // temps actif (valeur / fraction du temps effectivement comptee)
+    if (running > 0 && running < enabled) {
+      counters.values[c] += static_cast<std::uint64_t>(
+          static_cast<double>(value) * static_cast<double>(enabled) /
+          static_cast<double>(running));
+    } else {
+      counters.values[c] += value;
+    }
+  }
+  counters.nanoseconds += static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(finished -
+                                                           started_time_)
+          .count());
+  ++counters.runs;
+}
+
+const PhaseCounters &PerfProfiler::phase(EnginePhase phase) const {
+  return phases_[static_cast<std::size_t>(phase)];
+}
+
+void PerfProfiler::clear() { phases_ = {}; }
+
+const char *PerfProfiler::counter_name(HardwareCounter counter) {
+  switch (counter) {
+  case HardwareCounter::Cycles:
+    return "cycles";
+  case HardwareCounter::Instructions:
+    return "instructions";
+  case HardwareCounter::BranchMisses:
+    return "branch_misses";
+  case HardwareCounter::LlcMisses:
+    return "llc_misses";
+  }
+  return "unknown";
+}
+
+const char *PerfProfiler::phase_name(EnginePhase phase) {
+  switch (phase) {
+  case EnginePhase::Seeding:
+    return "seeding";
+  case EnginePhase::EventLoop:
+    return "event_loop";
+  case EnginePhase::Report:
+    return "report";
+  }
+  return "unknown";
+}
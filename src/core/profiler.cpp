@@ -0,0 +1,116 @@
+#include "core/profiler.h"
+
+#include <iomanip>
+#include <locale>
+#include <string>
+
+namespace {
+
+constexpr int kEnginePid = 1;
+constexpr int kEngineTid = 1;
+// Identifiants de piste : 1000 + i (salles), 2000 + i (chirurgiens),
+// 3000 + i (lits).
+constexpr int kLaneBase[] = {1000, 2000, 3000};
+const char *const kLaneName[] = {"Salle ", "Chirurgien ", "Lit "};
+
+// Minutes simulees -> microsecondes affichees (1 min = 1 s).
+constexpr double kSimulatedScale = 1e6;
+
+double microseconds(EngineProfiler::Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+ChromeTraceWriter::ChromeTraceWriter(std::ostream &out)
+    : out_(out), origin_(Clock::now()) {
+  line_.imbue(std::locale::classic());
+  line_ << std::fixed << std::setprecision(3);
+  out_ << "{\"traceEvents\":[";
+  metadata("process_name", kEnginePid, kEngineTid, "name",
+           "Moteur (temps reel)");
+  metadata("thread_name", kEnginePid, kEngineTid, "name", "Simulation::run");
+}
+
+ChromeTraceWriter::~ChromeTraceWriter() { finish(); }
+
+void ChromeTraceWriter::finish() {
+  if (finished_)
+    return;
+  finished_ = true;
+  out_ << "\n],\"displayTimeUnit\":\"ms\"}\n" << std::flush;
+}
+
+std::ostream &ChromeTraceWriter::begin_event() {
+  line_.str(std::string());
+  line_ << (first_ ? "\n" : ",\n");
+  first_ = false;
+  return line_;
+}
+
+void ChromeTraceWriter::end_event() {
+  const std::string text = line_.str();
+  out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+void ChromeTraceWriter::metadata(const char *name, int pid, int tid,
+                                 const char *key, const std::string &value) {
+  begin_event() << "{\"name\":\"" << name << "\",\"ph\":\"M\",\"pid\":"
+                << pid << ",\"tid\":" << tid << ",\"args\":{\"" << key
+                << "\":\"" << value << "\"}}";
+  end_event();
+}
+
+void ChromeTraceWriter::begin_run() {
+  ++run_pid_;
+  for (std::vector<double> &lanes : lanes_)
+    lanes.clear();
+  metadata("process_name", run_pid_, 0, "name",
+           "Run " + std::to_string(run_pid_ - 1) + " (temps simule)");
+}
+
+void ChromeTraceWriter::span(const char *name, Clock::time_point start,
+                             Clock::time_point end) {
+  begin_event() << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":"
+                << kEnginePid << ",\"tid\":" << kEngineTid
+                << ",\"ts\":" << microseconds(start - origin_)
+                << ",\"dur\":" << microseconds(end - start) << '}';
+  end_event();
+}
+
+void ChromeTraceWriter::occupancy(ResourceKind kind, int patient_id,
+                                  PatientType type, double start,
+                                  double end) {
+  const std::size_t k = static_cast<std::size_t>(kind);
+  std::vector<double> &lanes = lanes_[k];
+  // Occupations recues par debut croissant : la premiere piste libre suffit
+  // (pas plus de pistes que de ressources occupees simultanement).
+  std::size_t lane = 0;
+  while (lane < lanes.size() && lanes[lane] > start)
+    ++lane;
+  const int tid = kLaneBase[k] + static_cast<int>(lane);
+  if (lane == lanes.size()) {
+    lanes.push_back(end);
+    metadata("thread_name", run_pid_, tid, "name",
+             kLaneName[k] + std::to_string(lane + 1));
+  } else {
+    lanes[lane] = end;
+  }
+
+  const bool urgent = type == PatientType::Urgent;
+  begin_event() << "{\"name\":\"Patient " << patient_id
+                << (urgent ? " (urgence)" : " (programme)") << "\",\"cat\":\""
+                << (urgent ? "urgent" : "elective")
+                << "\",\"ph\":\"X\",\"pid\":" << run_pid_
+                << ",\"tid\":" << tid
+                << ",\"ts\":" << start * kSimulatedScale
+                << ",\"dur\":" << (end - start) * kSimulatedScale
+                << ",\"args\":{\"patient\":" << patient_id
+                << ",\"start_min\":" << start << ",\"end_min\":" << end
+                << "}}";
+  end_event();
+}
+
+std::size_t ChromeTraceWriter::lanes(ResourceKind kind) const {
+  return lanes_[static_cast<std::size_t>(kind)].size();
+}
@@ -0,0 +1,195 @@
+#include "core/replay.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+bool is_waiting(ReplayState state) {
+  return state == ReplayState::Waiting || state == ReplayState::Unscheduled ||
+         state == ReplayState::Cancelled;
+}
+
+} // namespace
+
+ReplayCursor::ReplayCursor(const PatientTable &patients,
+                           double horizon_minutes,
+                           double late_threshold_minutes)
+    : states_(patients.size(), ReplayState::NotArrived),
+      changed_mark_(patients.size(), 0),
+      waiting_slot_(patients.size(), 0),
+      time_(-std::numeric_limits<double>::infinity()) {
+  counts_[static_cast<std::size_t>(ReplayState::NotArrived)] =
+      static_cast<int>(patients.size());
+  transitions_.reserve(patients.size() * 5);
+
+  // Transitions d'un patient dans l'ordre de son parcours : a temps egal,
+  // le tri stable les applique dans cet ordre.
+  for (std::size_t i = 0; i < patients.size(); ++i) {
+    const std::uint32_t row = static_cast<std::uint32_t>(i);
+    const double arrival = patients.arrival_time[i];
+    const double start_surgery = patients.start_surgery_time[i];
+    const double end_surgery = patients.end_surgery_time[i];
+    const double start_recovery = patients.start_recovery_time[i];
+    const double end_recovery = patients.end_recovery_time[i];
+
+    if (start_surgery < 0) {
+      transitions_.push_back({arrival, row, ReplayState::Unscheduled});
+      transitions_.push_back({std::max(arrival, horizon_minutes), row,
+                              ReplayState::Cancelled});
+      continue;
+    }
+    transitions_.push_back({arrival, row, ReplayState::Waiting});
+    transitions_.push_back({start_surgery, row, ReplayState::InSurgery});
+    transitions_.push_back({end_surgery, row, ReplayState::AwaitingBed});
+    activity_end_ = std::max(activity_end_, end_surgery);
+    if (start_recovery >= 0) {
+      transitions_.push_back({start_recovery, row, ReplayState::InRecovery});
+      transitions_.push_back({end_recovery, row, ReplayState::Discharged});
+      activity_end_ = std::max(activity_end_, end_recovery);
+    }
+    if (start_surgery - arrival > late_threshold_minutes)
+      late_times_.push_back(arrival + late_threshold_minutes);
+  }
+
+  // Index des phases : les transitions sont encore groupees par ligne.
+  phase_offsets_.assign(patients.size() + 1, 0);
+  for (std::size_t k = 0; k < transitions_.size(); ++k) {
+    ReplayTransition &transition = transitions_[k];
+    if (k > 0 && transitions_[k - 1].row == transition.row)
+      transition.from = transitions_[k - 1].state;
+    ++phase_offsets_[transition.row + 1];
+  }
+  for (std::size_t r = 0; r < patients.size(); ++r)
+    phase_offsets_[r + 1] += phase_offsets_[r];
+  phases_ = transitions_;
+
+  std::stable_sort(transitions_.begin(), transitions_.end(),
+                   [](const ReplayTransition &a, const ReplayTransition &b) {
+                     return a.time < b.time;
+                   });
+  std::sort(late_times_.begin(), late_times_.end());
+
+  // Images cles des compteurs, la derniere couvrant la fin du flux.
+  std::array<int, kReplayStates> counts = counts_;
+  keyframes_.reserve(transitions_.size() / kKeyframeInterval + 1);
+  for (std::size_t k = 0; k <= transitions_.size(); ++k) {
+    if (k % kKeyframeInterval == 0)
+      keyframes_.push_back(counts);
+    if (k < transitions_.size()) {
+      --counts[static_cast<std::size_t>(transitions_[k].from)];
+      ++counts[static_cast<std::size_t>(transitions_[k].state)];
+    }
+  }
+}
+
+ReplayState ReplayCursor::state_at(std::size_t row, double t) const {
+  ReplayState state = ReplayState::NotArrived;
+  for (std::uint32_t k = phase_offsets_[row]; k < phase_offsets_[row + 1];
+       ++k) {
+    if (phases_[k].time > t)
+      break;
+    state = phases_[k].state;
+  }
+  return state;
+}
+
+void ReplayCursor::mark_changed(std::uint32_t row) {
+  if (!changed_mark_[row]) {
+    changed_mark_[row] = 1;
+    changed_.push_back(row);
+  }
+}
+
+void ReplayCursor::update_late(double t) {
+  late_ = static_cast<int>(
+      std::lower_bound(late_times_.begin(), late_times_.end(), t) -
+      late_times_.begin());
+}
+
+void ReplayCursor::set_waiting(std::uint32_t row, bool waiting) {
+  const bool was_waiting = is_waiting(states_[row]);
+  if (waiting == was_waiting)
+    return;
+  if (waiting) {
+    waiting_slot_[row] = static_cast<std::uint32_t>(waiting_.size());
+    waiting_.push_back(row);
+    return;
+  }
+  // Retrait en O(1) : la derniere ligne prend la place liberee.
+  const std::uint32_t slot = waiting_slot_[row];
+  const std::uint32_t last = waiting_.back();
+  waiting_[slot] = last;
+  waiting_slot_[last] = slot;
+  waiting_.pop_back();
+}
+
+void ReplayCursor::advance(double t) {
+  for (std::uint32_t row : changed_)
+    changed_mark_[row] = 0;
+  changed_.clear();
+  if (t < time_)
+    return;
+  time_ = t;
+
+  for (; next_ < transitions_.size() && transitions_[next_].time <= t;
+       ++next_) {
+    const ReplayTransition &transition = transitions_[next_];
+    const std::uint32_t row = transition.row;
+    set_waiting(row, is_waiting(transition.state));
+    --counts_[static_cast<std::size_t>(states_[row])];
+    ++counts_[static_cast<std::size_t>(transition.state)];
+    states_[row] = transition.state;
+    mark_changed(row);
+  }
+  update_late(t);
+}
+
+void ReplayCursor::seek(double t) {
+  for (std::uint32_t row : changed_)
+    changed_mark_[row] = 0;
+  changed_.clear();
+  time_ = t;
+  if (transitions_.empty())
+    return;
+
+  const std::size_t target = static_cast<std::size_t>(
+      std::upper_bound(transitions_.begin(), transitions_.end(), t,
+                       [](double value, const ReplayTransition &transition) {
+                         return value < transition.time;
+                       }) -
+      transitions_.begin());
+
+  // Lignes candidates : celles des transitions entre les deux positions, ou
+  // toutes si l'ecart est plus long que la table.
+  const std::size_t lo = std::min(next_, target);
+  const std::size_t hi = std::max(next_, target);
+  if (hi - lo < states_.size()) {
+    for (std::size_t k = lo; k < hi; ++k)
+      mark_changed(transitions_[k].row);
+  } else {
+    for (std::size_t r = 0; r < states_.size(); ++r)
+      mark_changed(static_cast<std::uint32_t>(r));
+  }
+  std::size_t kept = 0;
+  for (std::uint32_t row : changed_) {
+    const ReplayState state = state_at(row, t);
+    if (state == states_[row]) {
+      changed_mark_[row] = 0;
+      continue;
+    }
+    set_waiting(row, is_waiting(state));
+    states_[row] = state;
+    changed_[kept++] = row;
+  }
+  changed_.resize(kept);
+
+  const std::size_t key = target / kKeyframeInterval;
+  counts_ = keyframes_[key];
+  for (std::size_t k = key * kKeyframeInterval; k < target; ++k) {
+    --counts_[static_cast<std::size_t>(transitions_[k].from)];
+    ++counts_[static_cast<std::size_t>(transitions_[k].state)];
+  }
+  next_ = target;
+  update_late(t);
+}
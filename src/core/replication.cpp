@@ -0,0 +1,233 @@
+#include "core/replication.h"
+#include "core/scenario.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Distribue les indices [0, count) sur `threads` threads. Chaque thread
+// recoit son numero (pour ses ressources propres) et l'indice a traiter.
+template <typename Job>
+void parallel_for_index(int count, int threads, Job &&job) {
+  std::atomic<int> next{0};
+  std::exception_ptr failure;
+  std::mutex failure_mutex;
+
+  auto worker = [&](int worker_id) {
+    try {
+      for (int i = next++; i < count; i = next++)
+        job(worker_id, i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(failure_mutex);
+      if (!failure)
+        failure = std::current_exception();
+      next = count; // les autres threads s'arretent au prochain indice
+    }
+  };
+
+  const int used = std::max(1, std::min(threads, count));
+  std::vector<std::thread> pool;
+  pool.reserve(used - 1);
+  for (int t = 1; t < used; ++t)
+    pool.emplace_back(worker, t);
+  worker(0);
+  for (auto &thread : pool)
+    thread.join();
+
+  if (failure)
+    std::rethrow_exception(failure);
+}
+
+} // namespace
+
+const std::vector<ReportMetric> &report_metrics() {
+  static const std::vector<ReportMetric> metrics = {
+      {"patients_arrived",
+       [](const SimulationReport &r) { return double(r.patients_arrived); }},
+      {"urgent_arrived",
+       [](const SimulationReport &r) { return double(r.urgent_arrived); }},
+      {"elective_arrived",
+       [](const SimulationReport &r) { return double(r.elective_arrived); }},
+      {"patients_operated",
+       [](const SimulationReport &r) { return double(r.patients_operated); }},
+      {"patients_completed",
+       [](const SimulationReport &r) { return double(r.patients_completed); }},
+      {"average_wait_to_surgery",
+       [](const SimulationReport &r) { return r.average_wait_to_surgery; }},
+      {"average_wait_to_recovery",
+       [](const SimulationReport &r) { return r.average_wait_to_recovery; }},
+      {"average_total_time_in_system",
+       [](const SimulationReport &r) {
+         return r.average_total_time_in_system;
+       }},
+      {"max_wait_to_surgery",
+       [](const SimulationReport &r) { return r.max_wait_to_surgery; }},
+      {"operating_room_utilization",
+       [](const SimulationReport &r) { return r.operating_room_utilization; }},
+      {"recovery_bed_utilization",
+       [](const SimulationReport &r) { return r.recovery_bed_utilization; }},
+      {"surgeon_utilization",
+       [](const SimulationReport &r) { return r.surgeon_utilization; }},
+      {"throughput_per_hour",
+       [](const SimulationReport &r) { return r.throughput_per_hour; }},
+      {"pending_waiting",
+       [](const SimulationReport &r) { return double(r.pending_waiting); }},
+      {"operations_delayed",
+       [](const SimulationReport &r) { return double(r.operations_delayed); }},
+      {"operations_cancelled",
+       [](const SimulationReport &r) {
+         return double(r.operations_cancelled);
+       }},
+  };
+  return metrics;
+}
+
+ReplicationSummary::ReplicationSummary()
+    : metrics(report_metrics().size()) {}
+
+ReplicationSummary ReplicationSummary::single(const SimulationReport &report) {
+  ReplicationSummary summary;
+  summary.add(report);
+  return summary;
+}
+
+int ReplicationSummary::replications() const {
+  return metrics.empty() ? 0 : static_cast<int>(metrics.front().count);
+}
+
+void ReplicationSummary::add(const SimulationReport &report) {
+  const auto &defs = report_metrics();
+  for (size_t i = 0; i < defs.size(); ++i)
+    metrics[i].add(defs[i].extract(report));
+}
+
+void ReplicationSummary::add_difference(const SimulationReport &report,
+                                        const SimulationReport &reference) {
+  const auto &defs = report_metrics();
+  for (size_t i = 0; i < defs.size(); ++i)
+    metrics[i].add(defs[i].extract(report) - defs[i].extract(reference));
+}
+
+void ReplicationSummary::merge(const ReplicationSummary &other) {
+  for (size_t i = 0; i < metrics.size(); ++i)
+    metrics[i].merge(other.metrics[i]);
+}
+
+const RunningStat &ReplicationSummary::metric(const std::string &name) const {
+  const auto &defs = report_metrics();
+  for (size_t i = 0; i < defs.size(); ++i) {
+    if (name == defs[i].name)
+      return metrics[i];
+  }
+  throw std::out_of_range("KPI inconnu : " + name);
+}
+
+ReplicationRunner::ReplicationRunner(SimulationConfig base, int threads)
+    : base_(std::move(base)) {
+  if (threads <= 0)
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  threads_ = std::max(1, threads);
+}
+
+namespace {
+
+std::vector<RandomStreams> replication_streams(unsigned int seed, int count) {
+  // Flux calcules sequentiellement (un long_jump par replication) avant
+  // la distribution sur les threads.
+  std::vector<RandomStreams> streams;
+  streams.reserve(std::max(0, count));
+  ReplicationStreams generator(seed);
+  for (int i = 0; i < count; ++i)
+    streams.push_back(generator.next());
+  return streams;
+}
+
+// Pas plus de threads (et de moteurs) que de replications.
+int pool_size(int threads, int replications) {
+  return std::max(1, std::min(threads, replications));
+}
+
+} // namespace
+
+ReplicationSummary ReplicationRunner::run(int replications) {
+  reports_.assign(std::max(0, replications), SimulationReport{});
+  allocations_.assign(std::max(0, replications), AllocationStats{});
+
+  SimulationConfig config = base_;
+  config.trace_events = false;
+
+  const std::vector<RandomStreams> streams =
+      replication_streams(base_.seed, replications);
+
+  // Un moteur par thread utilise, reinitialise a chaque replication.
+  const int workers = pool_size(threads_, replications);
+  std::vector<Simulation> engines(workers, Simulation(config));
+  std::vector<ReplicationSummary> partials(std::max(0, replications));
+  parallel_for_index(replications, workers, [&](int worker, int index) {
+    Simulation &engine = engines[worker];
+    AllocationScope scope(memory_budget_);
+    engine.reset(config, streams[index]);
+    reports_[index] = engine.run();
+    allocations_[index] = scope.stats();
+    partials[index] = ReplicationSummary::single(reports_[index]);
+  });
+
+  // Fusion dans l'ordre des replications : resultat identique au bit
+  // pres quel que soit le nombre de threads.
+  ReplicationSummary summary;
+  for (const ReplicationSummary &partial : partials)
+    summary.merge(partial);
+  return summary;
+}
+
+ComparisonSummary
+ReplicationRunner::compare(const std::vector<SimulationConfig> &variants,
+                           int replications) {
+  for (const SimulationConfig &variant : variants) {
+    if (!same_patient_flow(base_, variant)) {
+      throw std::invalid_argument(
+          "Comparaison CRN : une variante modifie le flux de patients");
+    }
+  }
+  replications = std::max(0, replications);
+  const size_t variant_count = variants.size();
+  const std::vector<RandomStreams> streams =
+      replication_streams(base_.seed, replications);
+
+  // reports[r * variant_count + v] : variante v sur le scenario r.
+  std::vector<SimulationReport> reports(replications * variant_count);
+  allocations_.assign(replications, AllocationStats{});
+  const int workers = pool_size(threads_, replications);
+  std::vector<Simulation> engines(workers, Simulation(base_));
+  parallel_for_index(replications, workers, [&](int worker, int index) {
+    Simulation &engine = engines[worker];
+    AllocationScope scope(memory_budget_);
+    const auto scenario = Scenario::generate(base_, streams[index]);
+    for (size_t v = 0; v < variant_count; ++v) {
+      SimulationConfig config = variants[v];
+      config.trace_events = false;
+      engine.reset(config, streams[index]);
+      engine.set_scenario(scenario);
+      reports[index * variant_count + v] = engine.run();
+    }
+    engine.set_scenario(nullptr);
+    allocations_[index] = scope.stats();
+  });
+
+  ComparisonSummary summary;
+  summary.variants.resize(variant_count);
+  summary.differences.resize(variant_count);
+  for (int r = 0; r < replications; ++r) {
+    const SimulationReport *row = &reports[r * variant_count];
+    for (size_t v = 0; v < variant_count; ++v) {
+      summary.variants[v].add(row[v]);
+      summary.differences[v].add_difference(row[v], row[0]);
+    }
+  }
+  return summary;
+}
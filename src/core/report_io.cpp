@@ -0,0 +1,278 @@
+#include "core/report_io.h"
+
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Nombre au format C (point decimal, 10 chiffres significatifs). JSON n'a
+// pas de NaN ni d'infini : ils deviennent null.
+std::string format_number(double value, bool json) {
+  if (!std::isfinite(value))
+    return json ? "null" : "";
+  std::ostringstream os;
+  os.imbue(std::locale::classic());
+  os << std::setprecision(10) << value;
+  return os.str();
+}
+
+// Bloc "memory" des allocations d'un run ou d'un point.
+void write_memory_stats(std::ostream &out, const AllocationStats &stats) {
+  out << "\"memory\":{\"allocations\":" << stats.allocations
+      << ",\"deallocations\":" << stats.deallocations
+      << ",\"bytes\":" << stats.bytes
+      << ",\"peak_live_bytes\":" << stats.peak_live_bytes << '}';
+}
+
+// Bloc "engine" des compteurs du moteur (config.collect_stats).
+void write_engine_stats(std::ostream &out, const EngineStats &stats) {
+  out << "\"engine\":{\"events\":{";
+  for (std::size_t t = 0; t < EngineStats::kEventTypes; ++t) {
+    out << (t ? "," : "") << '"' << event_type_name(static_cast<EventType>(t))
+        << "\":" << stats.events[t];
+  }
+  out << "},\"handler_ns\":{";
+  for (std::size_t t = 0; t < EngineStats::kEventTypes; ++t) {
+    out << (t ? "," : "") << '"' << event_type_name(static_cast<EventType>(t))
+        << "\":" << stats.handler_nanoseconds[t];
+  }
+  out << "},\"picks\":" << stats.picks
+      << ",\"pick_ns\":" << stats.pick_nanoseconds
+      << ",\"max_event_queue\":" << stats.max_event_queue
+      << ",\"mean_event_queue\":" << format_number(stats.mean_event_queue, true)
+      << ",\"max_waiting_surgery\":" << stats.max_waiting_surgery
+      << ",\"max_waiting_recovery\":" << stats.max_waiting_recovery << '}';
+}
+
+} // namespace
+
+OutputFormat parse_output_format(const std::string &value) {
+  if (value == "csv")
+    return OutputFormat::Csv;
+  if (value == "jsonl" || value == "json")
+    return OutputFormat::JsonLines;
+  throw std::invalid_argument("Format de sortie inconnu : " + value);
+}
+
+BatchWriter::BatchWriter(std::ostream &out, OutputFormat format,
+                         unsigned int seed)
+    : out_(out), format_(format), seed_(seed) {
+  if (format_ != OutputFormat::Csv)
+    return;
+  out_ << "record,replication,statistic";
+  for (const ReportMetric &metric : report_metrics())
+    out_ << ',' << metric.name;
+  out_ << '\n' << std::flush;
+}
+
+void BatchWriter::write_run(int replication, const SimulationReport &report,
+                            const AllocationStats *memory) {
+  const auto &defs = report_metrics();
+  std::ostringstream line;
+  if (format_ == OutputFormat::Csv) {
+    line << "run," << replication << ",value";
+    for (const ReportMetric &metric : defs)
+      line << ',' << format_number(metric.extract(report), false);
+  } else {
+    line << "{\"record\":\"run\",\"replication\":" << replication
+         << ",\"seed\":" << seed_ << ",\"metrics\":{";
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+      line << (i ? "," : "") << '"' << defs[i].name
+           << "\":" << format_number(defs[i].extract(report), true);
+    }
+    line << '}';
+    if (report.engine.total_events() > 0) {
+      line << ',';
+      write_engine_stats(line, report.engine);
+    }
+    if (memory) {
+      line << ',';
+      write_memory_stats(line, *memory);
+    }
+    line << '}';
+  }
+  line << '\n';
+  out_ << line.str() << std::flush;
+}
+
+void BatchWriter::write_summary(const ReplicationSummary &summary) {
+  struct Statistic {
+    const char *name;
+    double (*value)(const RunningStat &stat);
+  };
+  static const Statistic statistics[] = {
+      {"mean", [](const RunningStat &s) { return s.mean; }},
+      {"stddev", [](const RunningStat &s) { return s.stddev(); }},
+      {"ci95", [](const RunningStat &s) { return s.ci95_half_width(); }},
+      {"ci95_low",
+       [](const RunningStat &s) { return s.mean - s.ci95_half_width(); }},
+      {"ci95_high",
+       [](const RunningStat &s) { return s.mean + s.ci95_half_width(); }},
+      {"min", [](const RunningStat &s) { return s.min; }},
+      {"max", [](const RunningStat &s) { return s.max; }},
+  };
+
+  const auto &defs = report_metrics();
+  std::ostringstream lines;
+  if (format_ == OutputFormat::Csv) {
+    for (const Statistic &statistic : statistics) {
+      lines << "summary," << summary.replications() << ',' << statistic.name;
+      for (const RunningStat &stat : summary.metrics)
+        lines << ',' << format_number(statistic.value(stat), false);
+      lines << '\n';
+    }
+  } else {
+    lines << "{\"record\":\"summary\",\"replications\":"
+          << summary.replications() << ",\"seed\":" << seed_
+          << ",\"metrics\":{";
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+      lines << (i ? "," : "") << '"' << defs[i].name << "\":{";
+      for (std::size_t k = 0; k < std::size(statistics); ++k) {
+        lines << (k ? "," : "") << '"' << statistics[k].name << "\":"
+              << format_number(statistics[k].value(summary.metrics[i]), true);
+      }
+      lines << '}';
+    }
+    lines << "}}\n";
+  }
+  out_ << lines.str() << std::flush;
+}
+
+SweepWriter::SweepWriter(std::ostream &out, OutputFormat format,
+                         std::vector<std::string> axes, bool header,
+                         const std::string &definition)
+    : out_(out), format_(format), axes_(std::move(axes)) {
+  if (!header)
+    return;
+  if (!definition.empty()) {
+    if (format_ == OutputFormat::Csv)
+      out_ << "# definition=" << definition << '\n';
+    else
+      out_ << "{\"definition\":\"" << definition << "\"}\n";
+    out_ << std::flush;
+  }
+  if (format_ != OutputFormat::Csv)
+    return;
+  out_ << "point";
+  for (const std::string &axis : axes_)
+    out_ << ',' << axis;
+  out_ << ",replications";
+  for (const ReportMetric &metric : report_metrics()) {
+    out_ << ',' << metric.name << "_mean," << metric.name << "_stddev,"
+         << metric.name << "_ci95";
+  }
+  out_ << '\n' << std::flush;
+}
+
+void SweepWriter::write_point(const SweepPointResult &result) {
+  const auto &defs = report_metrics();
+  // Ligne complete construite puis ecrite d'un bloc : un arret brutal ne
+  // laisse au pire qu'une derniere ligne tronquee (voir recover).
+  std::ostringstream line;
+  if (format_ == OutputFormat::Csv) {
+    line << result.point;
+    for (double value : result.values)
+      line << ',' << format_number(value, false);
+    line << ',' << result.summary.replications();
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+      const RunningStat &stat = result.summary.metrics[i];
+      line << ',' << format_number(stat.mean, false) << ','
+           << format_number(stat.stddev(), false) << ','
+           << format_number(stat.ci95_half_width(), false);
+    }
+  } else {
+    line << "{\"point\":" << result.point << ",\"config\":{";
+    for (std::size_t a = 0; a < axes_.size(); ++a) {
+      line << (a ? "," : "") << '"' << axes_[a]
+           << "\":" << format_number(result.values[a], true);
+    }
+    line << "},\"replications\":" << result.summary.replications()
+         << ",\"metrics\":{";
+    for (std::size_t i = 0; i < defs.size(); ++i) {
+      const RunningStat &stat = result.summary.metrics[i];
+      line << (i ? "," : "") << '"' << defs[i].name
+           << "\":{\"mean\":" << format_number(stat.mean, true)
+           << ",\"stddev\":" << format_number(stat.stddev(), true)
+           << ",\"ci95\":" << format_number(stat.ci95_half_width(), true)
+           << ",\"min\":" << format_number(stat.min, true)
+           << ",\"max\":" << format_number(stat.max, true) << '}';
+    }
+    line << '}';
+    if (result.memory.allocations > 0) {
+      line << ',';
+      write_memory_stats(line, result.memory);
+    }
+    line << '}';
+  }
+  line << '\n';
+  out_ << line.str() << std::flush;
+}
+
+std::vector<std::size_t> recover_sweep_output(const std::string &path,
+                                              OutputFormat format,
+                                              const std::string &definition) {
+  std::vector<std::size_t> points;
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return points;
+  std::ostringstream buffer;
+  buffer << in.rdbuf();
+  in.close();
+  const std::string content = buffer.str();
+
+  // Derniere ligne sans fin de ligne : ecriture interrompue, on la retire.
+  const std::size_t last_newline = content.rfind('\n');
+  const std::size_t complete =
+      (last_newline == std::string::npos) ? 0 : last_newline + 1;
+
+  // Empreinte ecrite en premiere ligne par SweepWriter
+  if (!definition.empty() && complete > 0) {
+    const std::string first = content.substr(0, content.find('\n'));
+    const std::string key = format == OutputFormat::Csv
+                                ? std::string("# definition=")
+                                : std::string("{\"definition\":\"");
+    std::string found;
+    if (first.compare(0, key.size(), key) == 0) {
+      found = first.substr(key.size());
+      if (format == OutputFormat::JsonLines)
+        found = found.substr(0, found.find('"'));
+    }
+    if (found != definition) {
+      throw std::invalid_argument(
+          "Reprise refusee : " + path +
+          (found.empty() ? " ne porte pas d'empreinte de balayage"
+                         : " provient d'une autre definition de balayage (" +
+                               found + ", attendu " + definition + ")"));
+    }
+  }
+  if (complete < content.size())
+    std::filesystem::resize_file(path, complete);
+
+  std::istringstream lines(content.substr(0, complete));
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::size_t start = 0;
+    if (format == OutputFormat::JsonLines) {
+      const std::string key = "\"point\":";
+      start = line.find(key);
+      if (start == std::string::npos)
+        continue;
+      start += key.size();
+    }
+    std::size_t end = start;
+    while (end < line.size() &&
+           std::isdigit(static_cast<unsigned char>(line[end])))
+      ++end;
+    if (end == start)
+      continue; // en-tete CSV ou ligne etrangere
+    points.push_back(std::stoull(line.substr(start, end - start)));
+  }
+  return points;
+}
@@ -0,0 +1,36 @@
+#include "core/run_control.h"
+
+#include <algorithm>
+
+void RunControl::begin(double horizon_minutes) {
+  horizon_ = horizon_minutes;
+  step_ = -1;
+  publish(0.0);
+  if (cancel_requested())
+    throw SimulationCancelled();
+}
+
+void RunControl::checkpoint(double now) {
+  publish(now);
+  if (cancel_requested())
+    throw SimulationCancelled();
+}
+
+void RunControl::finish() {
+  // Le run deborde l'horizon (patients encore en cours) : fin = 100 %
+  const double end = std::max(horizon_, simulated_minutes());
+  step_ = kProgressSteps - 1;
+  publish(end);
+}
+
+void RunControl::publish(double now) {
+  simulated_.store(now, std::memory_order_relaxed);
+  if (!on_progress)
+    return;
+  const double ratio = horizon_ > 0.0 ? std::min(1.0, now / horizon_) : 1.0;
+  const int step = static_cast<int>(ratio * kProgressSteps);
+  if (step > step_) {
+    step_ = step;
+    on_progress(now, horizon_);
+  }
+}
@@ -0,0 +1,39 @@
+#include "core/scenario.h"
+
+void generate_patients(const SimulationConfig &config, RandomStreams &streams,
+                       PatientTable &patients, PatientSource &source) {
+  patients.clear();
+  source.reset(config);
+  Patient patient;
+  while (source.next_elective(streams, patient))
+    patients.push_back(patient);
+  while (source.next_urgent(streams, patient))
+    patients.push_back(patient);
+}
+
+void generate_patients(const SimulationConfig &config, RandomStreams &streams,
+                       PatientTable &patients) {
+  PatientSource source;
+  generate_patients(config, streams, patients, source);
+}
+
+std::shared_ptr<const Scenario>
+Scenario::generate(const SimulationConfig &config,
+                   const RandomStreams &streams) {
+  auto scenario = std::make_shared<Scenario>();
+  scenario->config = config;
+  RandomStreams local = streams;
+  generate_patients(config, local, scenario->patients);
+  return scenario;
+}
+
+bool same_patient_flow(const SimulationConfig &a, const SimulationConfig &b) {
+  return a.horizon_hours == b.horizon_hours &&
+         a.elective_patients == b.elective_patients &&
+         a.elective_window_hours == b.elective_window_hours &&
+         a.urgent_rate_per_hour == b.urgent_rate_per_hour &&
+         a.mean_surgery_minutes_elective == b.mean_surgery_minutes_elective &&
+         a.mean_surgery_minutes_urgent == b.mean_surgery_minutes_urgent &&
+         a.mean_recovery_minutes == b.mean_recovery_minutes &&
+         a.duration_cv == b.duration_cv;
+}
@@ -1,20 +1,11 @@
 #include "core/simulation.h"
+#include "core/scenario.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
-
-namespace {
-
-std::string format_minutes(double minutes) {
-  std::ostringstream os;
-  os << std::fixed << std::setprecision(1) << minutes;
-  return os.str();
-}
-
-} // namespace
+#include <stdexcept>
 
 std::string scheduling_policy_to_string(SchedulingPolicy policy) {
   switch (policy) {
@@ -28,33 +19,132 @@ std::string scheduling_policy_to_string(SchedulingPolicy policy) {
   return "unknown";
 }
 
+const char *event_type_name(EventType type) {
+  switch (type) {
+  case EventType::Arrival:
+    return "arrival";
+  case EventType::SurgeryEnd:
+    return "surgery_end";
+  case EventType::CleaningEnd:
+    return "cleaning_end";
+  case EventType::RecoveryEnd:
+    return "recovery_end";
+  }
+  return "unknown";
+}
+
+std::uint64_t EngineStats::total_events() const {
+  std::uint64_t total = 0;
+  for (std::uint64_t count : events)
+    total += count;
+  return total;
+}
+
+void EngineStats::merge(const EngineStats &other) {
+  const std::uint64_t mine = total_events();
+  const std::uint64_t theirs = other.total_events();
+  if (mine + theirs > 0) {
+    mean_event_queue = (mean_event_queue * static_cast<double>(mine) +
+                        other.mean_event_queue * static_cast<double>(theirs)) /
+                       static_cast<double>(mine + theirs);
+  }
+  for (std::size_t t = 0; t < kEventTypes; ++t) {
+    events[t] += other.events[t];
+    handler_nanoseconds[t] += other.handler_nanoseconds[t];
+  }
+  picks += other.picks;
+  pick_nanoseconds += other.pick_nanoseconds;
+  max_event_queue = std::max(max_event_queue, other.max_event_queue);
+  max_waiting_surgery = std::max(max_waiting_surgery, other.max_waiting_surgery);
+  max_waiting_recovery =
+      std::max(max_waiting_recovery, other.max_waiting_recovery);
+}
+
+namespace {
+
+using StatsClock = std::chrono::steady_clock;
+
+// Horloge lue seulement par les instances qui collectent les compteurs.
+template <class Mode> StatsClock::time_point stats_clock() {
+  if constexpr (Mode::stats)
+    return StatsClock::now();
+  else
+    return StatsClock::time_point();
+}
+
+std::uint64_t nanoseconds_between(StatsClock::time_point started,
+                                  StatsClock::time_point finished) {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started)
+          .count());
+}
+
+} // namespace
+
 Simulation::Simulation(SimulationConfig config)
-    : config_(std::move(config)),
-      event_compare_(
-          [](const Event &a, const Event &b) { return a.time > b.time; }),
-      events_(event_compare_), rng_(config_.seed),
-      urgent_interarrival_((config_.urgent_rate_per_hour > 0.0)
-                               ? (config_.urgent_rate_per_hour / 60.0)
-                               : 1.0) {
+    : Simulation(config, RandomStreams::from_seed(config.seed)) {}
+
+Simulation::Simulation(SimulationConfig config, const RandomStreams &streams)
+    : config_(std::move(config)), streams_(streams) {
+  reset(config_, streams);
+}
+
+void Simulation::reset(SimulationConfig config) {
+  const RandomStreams streams = RandomStreams::from_seed(config.seed);
+  reset(std::move(config), streams);
+}
+
+void Simulation::reset(SimulationConfig config, unsigned int seed) {
+  config.seed = seed;
+  reset(std::move(config), RandomStreams::from_seed(seed));
+}
+
+void Simulation::reset(SimulationConfig config, const RandomStreams &streams) {
+  config_ = std::move(config);
+  streams_ = streams;
   horizon_minutes_ = config_.horizon_hours * 60.0;
+  live_step_ = nullptr;
+  reserve_capacity();
 }
 
-double Simulation::draw_positive_duration(double mean_minutes) {
-  const double stddev = std::max(1.0, mean_minutes * 0.25);
-  std::normal_distribution<double> dist(mean_minutes, stddev);
-  double value = -1.0;
-  int guard = 0;
-  while (value <= 1.0 && guard < 16) {
-    value = dist(rng_);
-    ++guard;
-  }
-  return (value <= 1.0) ? mean_minutes : value;
+namespace {
+
+// Emplacements reserves d'office en mode flux (patients actifs attendus).
+constexpr std::size_t kStreamingSlots = 256;
+
+// Mode flux : numeros de file [0, kArrivalSequences) reserves aux arrivees
+// (id d'origine du patient, un int).
+constexpr std::uint64_t kArrivalSequences = std::uint64_t(1) << 32;
+
+} // namespace
+
+void Simulation::reserve_capacity() {
+  // Effectif attendu (programmes + taux x horizon) avec une marge de quatre
+  // ecarts-types sur le nombre d'urgences (loi de Poisson).
+  const double urgent_expected =
+      std::max(0.0, config_.urgent_rate_per_hour * config_.horizon_hours);
+  const std::size_t patients = static_cast<std::size_t>(
+      std::max(0, config_.elective_patients) + urgent_expected +
+      4.0 * std::sqrt(urgent_expected) + 16.0);
+  // En file : arrivees a venir + une fin de chirurgie, de nettoyage et de
+  // reveil au plus par ressource.
+  const std::size_t in_flight = static_cast<std::size_t>(
+      2 * std::max(0, config_.operating_rooms) +
+      std::max(0, config_.recovery_beds) + 2);
+  // Mode flux : seuls les patients actifs sont stockes, reservation bornee.
+  const std::size_t resident =
+      config_.streaming ? std::min(patients, kStreamingSlots + 4 * in_flight)
+                        : patients;
+  patients_.reserve(resident);
+  slot_references_.reserve(resident);
+  free_slots_.reserve(resident);
+  events_.reserve(resident + in_flight);
+  waiting_patients_.reserve(resident);
+  recovery_waiting_.reserve(resident);
 }
 
-double Simulation::draw_urgent_interarrival_minutes() {
-  // urgent_interarrival_ uses rate per minute
-  const double sample = urgent_interarrival_(rng_);
-  return (sample <= 0.0) ? 1.0 : sample;
+void Simulation::set_scenario(std::shared_ptr<const Scenario> scenario) {
+  scenario_ = std::move(scenario);
 }
 
 void Simulation::set_log_sink(
@@ -62,13 +152,25 @@ void Simulation::set_log_sink(
   log_sink_ = std::move(sink);
 }
 
-void Simulation::log_event(const std::string &message, double time) {
-  if (!config_.trace_events)
-    return;
-  if (log_sink_) {
-    log_sink_(message, time);
+void Simulation::emit_trace(TraceKind kind, int patient_id, double now,
+                            double cleaning_minutes) {
+  TraceRecord record;
+  record.time = now;
+  record.kind = kind;
+  record.patient_type = patients_.type[patient_id];
+  record.patient_id = patients_.id[patient_id];
+  record.busy_operating_rooms = busy_operating_rooms_;
+  record.busy_surgeons = busy_surgeons_;
+  record.busy_recovery_beds = busy_recovery_beds_;
+  record.surgeon_count = config_.surgeon_count;
+  record.cleaning_minutes = cleaning_minutes;
+  if (trace_sink_) {
+    trace_sink_->record(record);
+  } else if (log_sink_) {
+    log_sink_(format_trace_message(record), now);
   } else {
-    std::cout << "[t=" << format_minutes(time) << " min] " << message << '\n';
+    std::cout << "[t=" << format_minutes(now) << " min] "
+              << format_trace_message(record) << '\n';
   }
 }
 
@@ -76,101 +178,148 @@ void Simulation::seed_patients() {
   patients_.clear();
   waiting_patients_.clear();
   recovery_waiting_.clear();
-  events_ = EventQueue(event_compare_);
+  recovery_head_ = 0;
+  events_.clear();
   busy_operating_rooms_ = 0;
   busy_surgeons_ = 0;
 
   busy_recovery_beds_ = 0;
+  clock_ = 0.0;
+  run_finished_ = false;
   operating_room_busy_minutes_ = 0.0;
   surgeon_busy_minutes_ = 0.0;
   recovery_busy_minutes_ = 0.0;
-
-  const double elective_window_minutes =
-      std::max(0.1, config_.elective_window_hours) * 60.0;
-
-  for (int i = 0; i < config_.elective_patients; ++i) {
-    const double position = (i + 0.5) / std::max(1, config_.elective_patients);
-    const double arrival = position * elective_window_minutes;
-
-    Patient p(static_cast<int>(patients_.size()), PatientType::Elective,
-              arrival);
-    p.surgery_duration =
-        draw_positive_duration(config_.mean_surgery_minutes_elective);
-    p.recovery_duration = draw_positive_duration(config_.mean_recovery_minutes);
-    patients_.push_back(p);
-
-    push_event(Event{arrival, EventType::Arrival, p.id});
+  capacity_changed_at_ = 0.0;
+  room_capacity_minutes_ = 0.0;
+  surgeon_capacity_minutes_ = 0.0;
+  bed_capacity_minutes_ = 0.0;
+  patients_arrived_ = 0;
+  urgent_arrived_ = 0;
+  elective_arrived_ = 0;
+  operations_delayed_ = 0;
+  wait_to_surgery_ = RunningStat();
+  wait_to_recovery_ = RunningStat();
+  time_in_system_ = RunningStat();
+
+  free_slots_.clear();
+  slot_references_.clear();
+  streaming_ = config_.streaming && !scenario_;
+  if (streaming_) {
+    // Une arrivee d'avance par classe ; les suivantes sont tirees a
+    // l'arrivee de la precedente. Leurs numeros de file (ids d'origine)
+    // precedent ceux des autres evenements, comme en mode batch.
+    patients_.clear();
+    events_.reserve_sequences(kArrivalSequences);
+    source_.reset(config_);
+    spawn_arrival(PatientType::Elective);
+    spawn_arrival(PatientType::Urgent);
+    return;
   }
 
-  if (config_.urgent_rate_per_hour > 0.0) {
-    double current = draw_urgent_interarrival_minutes();
-
-    while (current <= horizon_minutes_) {
-      Patient p(static_cast<int>(patients_.size()), PatientType::Urgent,
-                current);
-
-      p.surgery_duration =
-          draw_positive_duration(config_.mean_surgery_minutes_urgent);
+  if (scenario_) {
+    if (!same_patient_flow(config_, scenario_->config)) {
+      throw std::invalid_argument(
+          "Le scenario ne correspond pas au flux de patients configure");
+    }
+    patients_ = scenario_->patients;
+  } else {
+    generate_patients(config_, streams_, patients_, source_);
+  }
 
-      p.recovery_duration =
-          draw_positive_duration(config_.mean_recovery_minutes);
+  // Programmes puis urgences forment deux suites deja triees, fusionnees
+  // directement dans la file : chaque insertion arrive en fin d'ordre et ne
+  // remonte pas le tas.
+  const std::size_t count = patients_.size();
+  std::size_t first_urgent = 0;
+  while (first_urgent < count &&
+         patients_.type[first_urgent] != PatientType::Urgent)
+    ++first_urgent;
+
+  std::size_t elective = 0;
+  std::size_t urgent = first_urgent;
+  while (elective < first_urgent || urgent < count) {
+    const bool take_urgent =
+        elective == first_urgent ||
+        (urgent < count &&
+         patients_.arrival_time[urgent] < patients_.arrival_time[elective]);
+    const std::size_t i = take_urgent ? urgent++ : elective++;
+    events_.push(Event{patients_.arrival_time[i], EventType::Arrival,
+                       static_cast<int>(i)});
+  }
+}
 
-      patients_.push_back(p);
+void Simulation::push_event(const Event &event) {
+  if (streaming_)
+    ++slot_references_[event.patient_id];
+  events_.push(event);
+}
 
-      push_event(Event{current, EventType::Arrival, p.id});
+void Simulation::spawn_arrival(PatientType type) {
+  Patient patient;
+  const bool available = (type == PatientType::Elective)
+                             ? source_.next_elective(streams_, patient)
+                             : source_.next_urgent(streams_, patient);
+  if (!available)
+    return;
+  const int slot = allocate_slot(patient);
+  ++slot_references_[slot];
+  // Departage des arrivees simultanees par id d'origine (programmes puis
+  // urgences), soit l'ordre de fusion du mode batch. Temps lu dans la table
+  // (meme encodage qu'en batch).
+  events_.push_sequenced(Event{patients_.arrival_time[slot],
+                               EventType::Arrival, slot,
+                               static_cast<std::uint64_t>(patient.id)});
+}
 
-      current += draw_urgent_interarrival_minutes();
-    }
+int Simulation::allocate_slot(const Patient &patient) {
+  int slot;
+  if (!free_slots_.empty()) {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    patients_.set_row(static_cast<std::size_t>(slot), patient);
+  } else {
+    slot = static_cast<int>(patients_.size());
+    patients_.push_back(patient);
+    slot_references_.push_back(0);
   }
+  slot_references_[slot] = 1; // reference du patient lui-meme
+  return slot;
+}
+
+void Simulation::release_slot(int slot) {
+  if (--slot_references_[slot] == 0)
+    free_slots_.push_back(slot);
 }
 
-void Simulation::push_event(const Event &event) { events_.push(event); }
+template <class Policy>
+ReadyKey Simulation::ready_key(int patient_id, std::uint64_t sequence) const {
+  ReadyKey key;
+  key.arrival = patients_.arrival_time[patient_id];
+  key.patient_id = patient_id;
+  key.sequence = sequence;
+  key.rank = Policy::rank(patients_.type[patient_id], key.arrival);
+  return key;
+}
 
-int Simulation::pick_next_patient(double now) {
+int Simulation::pick_next_patient() {
   if (waiting_patients_.empty())
     return -1;
-  int best_index = 0;
-  auto better = [&](int lhs_idx, int rhs_idx) {
-    const Patient &a = patients_[waiting_patients_[lhs_idx]];
-    const Patient &b = patients_[waiting_patients_[rhs_idx]];
-    switch (config_.policy) {
-    case SchedulingPolicy::Fifo: {
-      return a.arrival_time < b.arrival_time;
-    }
-    case SchedulingPolicy::PriorityFirst: {
-      const int priority_a = (a.type == PatientType::Urgent) ? 1 : 0;
-      const int priority_b = (b.type == PatientType::Urgent) ? 1 : 0;
-      if (priority_a != priority_b)
-        return priority_a > priority_b;
-      return a.arrival_time < b.arrival_time;
-    }
-    case SchedulingPolicy::Balanced: {
-      const double wait_a = now - a.arrival_time;
-      const double wait_b = now - b.arrival_time;
-      const double score_a =
-          ((a.type == PatientType::Urgent) ? 2.0 : 1.0) + wait_a / 60.0;
-      const double score_b =
-          ((b.type == PatientType::Urgent) ? 2.0 : 1.0) + wait_b / 60.0;
-      if (std::abs(score_a - score_b) > 1e-6)
-        return score_a > score_b;
-      return a.arrival_time < b.arrival_time;
-    }
-    }
-    return false;
-  };
+  return waiting_patients_.pop();
+}
 
-  for (size_t i = 1; i < waiting_patients_.size(); ++i) {
-    if (better(static_cast<int>(i), best_index)) {
-      best_index = static_cast<int>(i);
-    }
-  }
-  const int patient_id = waiting_patients_[best_index];
-  waiting_patients_[best_index] = waiting_patients_.back();
-  waiting_patients_.pop_back();
-  return patient_id;
+void Simulation::advance_clock(double now) {
+  // Integrale des ressources occupees depuis le dernier evenement (la salle
+  // reste comptee pendant le nettoyage).
+  const double elapsed = now - clock_;
+  if (elapsed <= 0.0)
+    return;
+  operating_room_busy_minutes_ += busy_operating_rooms_ * elapsed;
+  surgeon_busy_minutes_ += busy_surgeons_ * elapsed;
+  recovery_busy_minutes_ += busy_recovery_beds_ * elapsed;
+  clock_ = now;
 }
 
-void Simulation::try_schedule_surgery(double now) {
+template <class Mode> void Simulation::try_schedule_surgery(double now) {
   // On ne commence plus de nouvelles chirurgies si l'horizon est atteint ou
   // dépassé.
   if (now >= horizon_minutes_) {
@@ -179,75 +328,116 @@ void Simulation::try_schedule_surgery(double now) {
 
   while (busy_operating_rooms_ < config_.operating_rooms &&
          busy_surgeons_ < config_.surgeon_count && !waiting_patients_.empty()) {
-    const int patient_id = pick_next_patient(now);
+    [[maybe_unused]] const auto started = stats_clock<Mode>();
+    const int patient_id = pick_next_patient();
+    if constexpr (Mode::stats) {
+      const auto finished = StatsClock::now();
+      ++stats_.picks;
+      stats_.pick_nanoseconds += nanoseconds_between(started, finished);
+      if (profiler_)
+        profiler_->span("pick_next_patient", started, finished);
+    }
     if (patient_id < 0)
       return;
-    Patient &p = patients_[patient_id];
-    p.start_surgery_time = now;
-    p.end_surgery_time = now + p.surgery_duration;
+    const double duration = patients_.surgery_duration[patient_id];
+    const double end = now + duration;
+    patients_.start_surgery_time[patient_id] =
+        static_cast<patient_time_t>(now);
+    patients_.end_surgery_time[patient_id] = static_cast<patient_time_t>(end);
     ++busy_operating_rooms_;
     ++busy_surgeons_;
-    operating_room_busy_minutes_ += p.surgery_duration;
-    surgeon_busy_minutes_ += p.surgery_duration;
-    push_event(Event{p.end_surgery_time, EventType::SurgeryEnd, p.id});
-    log_event(
-        "Debut chirurgie patient " + std::to_string(p.id) +
-            ". (Chirurgien occupe : " + std::to_string(busy_surgeons_) + "/" +
-            std::to_string(config_.surgeon_count) + ")" +
-            (p.type == PatientType::Urgent ? " (urgence)" : " (programme)"),
-        now);
+
+    const double wait = now - patients_.arrival_time[patient_id];
+    wait_to_surgery_.add(wait);
+    // Retard : attente de plus de 15 min avant le bloc
+    if (wait > 15.0)
+      ++operations_delayed_;
+    push_event(Event{end, EventType::SurgeryEnd, patient_id});
+    trace<Mode>(TraceKind::SurgeryStart, patient_id, now);
+    if constexpr (Mode::stats) {
+      if (profiler_) {
+        // Id d'origine du patient, pas l'emplacement du mode flux
+        const int id = patients_.id[patient_id];
+        const PatientType type = patients_.type[patient_id];
+        profiler_->occupancy(ResourceKind::OperatingRoom, id, type, now,
+                             end + config_.cleaning_time_minutes);
+        profiler_->occupancy(ResourceKind::Surgeon, id, type, now, end);
+      }
+    }
   }
 }
 
-void Simulation::try_start_recovery(double now) {
+template <class Mode> void Simulation::try_start_recovery(double now) {
   while (busy_recovery_beds_ < config_.recovery_beds &&
-         !recovery_waiting_.empty()) {
-    const int patient_id = recovery_waiting_.front();
-    recovery_waiting_.pop_front();
-    Patient &p = patients_[patient_id];
-    p.start_recovery_time = now;
-    p.end_recovery_time = now + p.recovery_duration;
+         recovery_head_ < recovery_waiting_.size()) {
+    const int patient_id = recovery_waiting_[recovery_head_++];
+    // File consommee par l'avant : compactee des que la partie lue depasse
+    // la moitie, pour rester bornee sous un arriere persistant.
+    if (recovery_head_ == recovery_waiting_.size()) {
+      recovery_waiting_.clear();
+      recovery_head_ = 0;
+    } else if (recovery_head_ > recovery_waiting_.size() / 2) {
+      recovery_waiting_.erase(recovery_waiting_.begin(),
+                              recovery_waiting_.begin() + recovery_head_);
+      recovery_head_ = 0;
+    }
+    const double duration = patients_.recovery_duration[patient_id];
+    const double end = now + duration;
+    patients_.start_recovery_time[patient_id] =
+        static_cast<patient_time_t>(now);
+    patients_.end_recovery_time[patient_id] = static_cast<patient_time_t>(end);
     ++busy_recovery_beds_;
-    recovery_busy_minutes_ += p.recovery_duration;
-    push_event(Event{p.end_recovery_time, EventType::RecoveryEnd, p.id});
-    log_event("Debut reveil patient " + std::to_string(p.id), now);
+    wait_to_recovery_.add(now - patients_.end_surgery_time[patient_id]);
+    push_event(Event{end, EventType::RecoveryEnd, patient_id});
+    trace<Mode>(TraceKind::RecoveryStart, patient_id, now);
+    if constexpr (Mode::stats) {
+      if (profiler_) {
+        profiler_->occupancy(ResourceKind::RecoveryBed,
+                             patients_.id[patient_id],
+                             patients_.type[patient_id], now, end);
+      }
+    }
   }
 }
 
+template <class Policy, class Mode>
 void Simulation::handle_arrival(const Event &event, double now) {
-  Patient &p = patients_[event.patient_id];
-  waiting_patients_.push_back(p.id);
-  log_event("Patient " + std::to_string(p.id) +
-                (p.type == PatientType::Urgent ? " arrive (urgence)"
-                                               : " arrive (programme)"),
-            now);
-  try_schedule_surgery(now);
+  const int patient_id = event.patient_id;
+  if (streaming_)
+    spawn_arrival(patients_.type[patient_id]);
+  ++patients_arrived_;
+  if (patients_.type[patient_id] == PatientType::Urgent) {
+    ++urgent_arrived_;
+  } else {
+    ++elective_arrived_;
+  }
+  // Rang d'arrivee (1, 2, ...) : departage independant des emplacements
+  waiting_patients_.push(ready_key<Policy>(patient_id, patients_arrived_));
+  trace<Mode>(TraceKind::Arrival, patient_id, now);
+  try_schedule_surgery<Mode>(now);
 }
 
+template <class Policy, class Mode>
 void Simulation::handle_surgery_end(const Event &event, double now) {
-  Patient &p = patients_[event.patient_id];
-  if (busy_operating_rooms_ > 0) {
-    --busy_operating_rooms_;
-  }
+  const int patient_id = event.patient_id;
+  // La salle reste occupee jusqu'a la fin du nettoyage (CleaningEnd).
   if (busy_surgeons_ > 0) {
     --busy_surgeons_;
   }
 
-  log_event("Fin chirurgie patient " + std::to_string(p.id) +
-                ". Chirurgien libere" + ". Debut nettoyage (" +
-                format_minutes(config_.cleaning_time_minutes) + " min)",
-            now);
+  trace<Mode>(TraceKind::SurgeryEnd, patient_id, now,
+        config_.cleaning_time_minutes);
   double cleaning_end_time = now + config_.cleaning_time_minutes;
-  operating_room_busy_minutes_ += config_.cleaning_time_minutes;
 
-  push_event(Event{cleaning_end_time, EventType::CleaningEnd, p.id});
+  push_event(Event{cleaning_end_time, EventType::CleaningEnd, patient_id});
 
-  recovery_waiting_.push_back(p.id);
-  try_start_recovery(now);
+  recovery_waiting_.push_back(patient_id);
+  try_start_recovery<Mode>(now);
 
-  try_schedule_surgery(now);
+  try_schedule_surgery<Mode>(now);
 }
 
+template <class Policy, class Mode>
 void Simulation::handle_cleaning_end(const Event &event, double now) {
   // Le patient ID sert juste de référence ici, il est déjà en réveil.
 
@@ -256,124 +446,318 @@ void Simulation::handle_cleaning_end(const Event &event, double now) {
     --busy_operating_rooms_;
   }
 
-  log_event("Nettoyage termine apres patient " +
-                std::to_string(event.patient_id) + ". Salle libre.",
-            now);
+  trace<Mode>(TraceKind::CleaningEnd, event.patient_id, now);
 
   // C'est SEULEMENT maintenant qu'on peut prendre un nouveau patient
-  try_schedule_surgery(now);
+  try_schedule_surgery<Mode>(now);
 }
 
+template <class Policy, class Mode>
 void Simulation::handle_recovery_end(const Event &event, double now) {
-  Patient &p = patients_[event.patient_id];
   if (busy_recovery_beds_ > 0) {
     --busy_recovery_beds_;
   }
-  log_event("Fin reveil patient " + std::to_string(p.id), now);
-  (void)p;
-  try_start_recovery(now);
+  time_in_system_.add(now - patients_.arrival_time[event.patient_id]);
+  trace<Mode>(TraceKind::RecoveryEnd, event.patient_id, now);
+  if (streaming_)
+    release_slot(event.patient_id); // patient sorti
+  try_start_recovery<Mode>(now);
 }
 
-SimulationReport Simulation::run() {
-  seed_patients();
-
-  int patients_arrived = 0;
-  int urgent_arrived = 0;
-  int elective_arrived = 0;
+template <class Policy, class Mode>
+void Simulation::dispatch_event(const Event &event, double now) {
+  switch (event.type) {
+  case EventType::Arrival:
+    handle_arrival<Policy, Mode>(event, now);
+    break;
+  case EventType::CleaningEnd:
+    handle_cleaning_end<Policy, Mode>(event, now);
+    break;
+  case EventType::SurgeryEnd:
+    handle_surgery_end<Policy, Mode>(event, now);
+    break;
+  case EventType::RecoveryEnd:
+    handle_recovery_end<Policy, Mode>(event, now);
+    break;
+  }
+  if (streaming_)
+    release_slot(event.patient_id);
+}
 
+template <class Policy, class Mode> void Simulation::run_events() {
+  double queue_area = 0.0; // integrale de la taille de la file (stats)
+  double last_event = 0.0;
+  std::uint32_t until_check = RunControl::kCheckInterval;
   while (!events_.empty()) {
+    // Coupure : les evenements restants sont credites par finish_run()
+    if (events_.top().time > horizon_minutes_ * 2.25)
+      break;
+    if constexpr (Mode::stats) {
+      const std::size_t depth = events_.size();
+      stats_.max_event_queue = std::max(stats_.max_event_queue, depth);
+      queue_area += static_cast<double>(depth) *
+                    std::max(0.0, events_.top().time - last_event);
+      last_event = std::max(last_event, events_.top().time);
+    }
     const Event current = events_.top();
     events_.pop();
     const double now = current.time;
-    if (now > horizon_minutes_ * 2.25) {
-      break;
+    if (control_ && --until_check == 0) {
+      until_check = RunControl::kCheckInterval;
+      control_->checkpoint(now);
     }
-    switch (current.type) {
-    case EventType::Arrival:
-      ++patients_arrived;
-      if (patients_[current.patient_id].type == PatientType::Urgent) {
-        ++urgent_arrived;
-      } else {
-        ++elective_arrived;
-      }
-      handle_arrival(current, now);
+    advance_clock(now);
+    [[maybe_unused]] const auto started = stats_clock<Mode>();
+    [[maybe_unused]] const std::uint64_t picks_before = stats_.pick_nanoseconds;
+    dispatch_event<Policy, Mode>(current, now);
+    if constexpr (Mode::stats) {
+      const auto finished = StatsClock::now();
+      const std::size_t type = static_cast<std::size_t>(current.type);
+      ++stats_.events[type];
+      // Temps propre : les choix imbriques sont deja dans pick_nanoseconds
+      const std::uint64_t nested = stats_.pick_nanoseconds - picks_before;
+      const std::uint64_t elapsed = nanoseconds_between(started, finished);
+      stats_.handler_nanoseconds[type] += elapsed - std::min(elapsed, nested);
+      if (profiler_)
+        profiler_->span(event_type_name(current.type), started, finished);
+      stats_.max_waiting_surgery =
+          std::max(stats_.max_waiting_surgery, waiting_patients_.size());
+      stats_.max_waiting_recovery =
+          std::max(stats_.max_waiting_recovery,
+                   recovery_waiting_.size() - recovery_head_);
+    }
+  }
+  if constexpr (Mode::stats) {
+    if (last_event > 0.0)
+      stats_.mean_event_queue = queue_area / last_event;
+  }
+
+  // Final scheduling if some patients remained waiting without events.
+  // This should be rare but keeps counters consistent.
+  double now = horizon_minutes_;
+  try_schedule_surgery<Mode>(now);
+  try_start_recovery<Mode>(now);
+}
+
+void Simulation::finish_run() {
+  // Activites en cours a la fin du run (coupure a 2,25 x horizon) :
+  // creditees jusqu'a leur terme, comme les durees completes comptees au
+  // demarrage de chaque activite avant l'integration en ligne.
+  while (!events_.empty()) {
+    const Event pending = events_.top();
+    events_.pop();
+    const double remaining = std::max(0.0, pending.time - clock_);
+    switch (pending.type) {
+    case EventType::SurgeryEnd:
+      surgeon_busy_minutes_ += remaining;
+      operating_room_busy_minutes_ += remaining;
       break;
     case EventType::CleaningEnd:
-      handle_cleaning_end(current, now);
-      break;
-    case EventType::SurgeryEnd:
-      handle_surgery_end(current, now);
+      operating_room_busy_minutes_ += remaining;
       break;
     case EventType::RecoveryEnd:
-      handle_recovery_end(current, now);
+      recovery_busy_minutes_ += remaining;
+      break;
+    case EventType::Arrival:
       break;
     }
   }
+  run_finished_ = true;
+}
 
-  // Final scheduling if some patients remained waiting without events.
-  // This should be rare but keeps counters consistent.
-  double now = horizon_minutes_;
-  try_schedule_surgery(now);
-  try_start_recovery(now);
+template <class Policy, bool Trace> void Simulation::run_with_mode() {
+  if (config_.collect_stats || (profiler_ && profiler_->event_detail())) {
+    run_events<Policy, EngineMode<Trace, true>>();
+  } else {
+    run_events<Policy, EngineMode<Trace, false>>();
+  }
+}
 
-  SimulationReport report;
-  report.patients_arrived = patients_arrived;
-  report.urgent_arrived = urgent_arrived;
-  report.elective_arrived = elective_arrived;
-
-  double total_wait_to_surgery = 0.0;
-  double total_wait_to_recovery = 0.0;
-  double total_system_time = 0.0;
-  int patients_operated = 0;
-  int patients_recovered = 0;
-  int patients_started_recovery = 0;
-
-  for (const Patient &p : patients_) {
-    if (p.start_surgery_time >= 0.0) {
-      ++patients_operated;
-      const double wait = p.start_surgery_time - p.arrival_time;
-      total_wait_to_surgery += wait;
-      report.max_wait_to_surgery = std::max(report.max_wait_to_surgery, wait);
-
-      // --- Calcul du Retard ---
-      // Si c'est un patient programmé et qu'il attend > 15 min, il est en retard
-      if (wait > 15.0) {
-        report.operations_delayed++;
-      }
-    }
-    if (p.start_recovery_time >= 0.0) {
-      ++patients_started_recovery;
-      total_wait_to_recovery += p.start_recovery_time - p.end_surgery_time;
-    }
-    if (p.end_recovery_time >= 0.0) {
-      ++patients_recovered;
-      total_system_time += p.end_recovery_time - p.arrival_time;
-    }
+template <class Policy> void Simulation::run_with_policy() {
+  if (kTraceEnabled && config_.trace_events) {
+    run_with_mode<Policy, true>();
+  } else {
+    run_with_mode<Policy, false>();
   }
+}
 
-  report.patients_operated = patients_operated;
-  report.patients_completed = patients_recovered;
-  
-  // --- Calcul des Annulations ---
-  // Les patients "Annulés" sont ceux qui restent en attente (pending_waiting)
-  report.pending_waiting = std::max(0, patients_arrived - patients_operated);
-  report.operations_cancelled = report.pending_waiting;
+SimulationReport Simulation::run() {
+  const auto run_started = StatsClock::now();
+  stats_ = EngineStats{};
+  live_step_ = nullptr;
+  if (profiler_) {
+    profiler_->begin_run();
+    profiler_->enter(EnginePhase::Seeding);
+  }
+  if (control_)
+    control_->begin(horizon_minutes_);
+  seed_patients();
+  if (profiler_) {
+    profiler_->leave(EnginePhase::Seeding);
+    profiler_->span("seed_patients", run_started, StatsClock::now());
+    profiler_->enter(EnginePhase::EventLoop);
+  }
+  // Choix de l'instance une fois par run : la boucle ne teste plus ni la
+  // politique, ni la trace, ni les compteurs.
+  switch (config_.policy) {
+  case SchedulingPolicy::Fifo:
+    run_with_policy<FifoPolicy>();
+    break;
+  case SchedulingPolicy::PriorityFirst:
+    run_with_policy<PriorityFirstPolicy>();
+    break;
+  case SchedulingPolicy::Balanced:
+    run_with_policy<BalancedPolicy>();
+    break;
+  }
+  finish_run();
+  if (control_)
+    control_->finish();
+  if (!profiler_)
+    return report();
+
+  profiler_->leave(EnginePhase::EventLoop);
+  profiler_->enter(EnginePhase::Report);
+  SimulationReport result = report();
+  profiler_->leave(EnginePhase::Report);
+  profiler_->span("run", run_started, StatsClock::now());
+  return result;
+}
 
-  if (patients_operated > 0) {
-    report.average_wait_to_surgery = total_wait_to_surgery / patients_operated;
+template <class Policy, class Mode> bool Simulation::live_step() {
+  if (events_.empty() || events_.top().time > horizon_minutes_ * 2.25) {
+    // Meme fin que run_events : derniere tentative a l'horizon
+    try_schedule_surgery<Mode>(horizon_minutes_);
+    try_start_recovery<Mode>(horizon_minutes_);
+    live_step_ = nullptr;
+    finish_run();
+    return false;
   }
-  if (patients_recovered > 0) {
-    report.average_total_time_in_system =
-        total_system_time / patients_recovered;
+  const Event current = events_.top();
+  events_.pop();
+  advance_clock(current.time);
+  dispatch_event<Policy, Mode>(current, current.time);
+  return true;
+}
+
+template <class Mode> void Simulation::live_reschedule(double now) {
+  try_schedule_surgery<Mode>(now);
+  try_start_recovery<Mode>(now);
+}
+
+template <class Policy> void Simulation::start_with_policy() {
+  if (kTraceEnabled && config_.trace_events) {
+    live_step_ = &Simulation::live_step<Policy, EngineMode<true, false>>;
+    live_reschedule_ = &Simulation::live_reschedule<EngineMode<true, false>>;
+  } else {
+    live_step_ = &Simulation::live_step<Policy, EngineMode<false, false>>;
+    live_reschedule_ = &Simulation::live_reschedule<EngineMode<false, false>>;
   }
-  if (patients_started_recovery > 0) {
-    report.average_wait_to_recovery =
-        total_wait_to_recovery / patients_started_recovery;
+}
+
+void Simulation::start() {
+  stats_ = EngineStats{};
+  seed_patients();
+  switch (config_.policy) {
+  case SchedulingPolicy::Fifo:
+    start_with_policy<FifoPolicy>();
+    break;
+  case SchedulingPolicy::PriorityFirst:
+    start_with_policy<PriorityFirstPolicy>();
+    break;
+  case SchedulingPolicy::Balanced:
+    start_with_policy<BalancedPolicy>();
+    break;
   }
+}
+
+bool Simulation::step() {
+  return live_step_ && (this->*live_step_)();
+}
+
+void Simulation::run_until(double t) {
+  while (live_step_ && (events_.empty() || events_.top().time <= t))
+    (this->*live_step_)();
+}
+
+SimulationState Simulation::state() const {
+  SimulationState state;
+  state.clock = clock_;
+  state.busy_operating_rooms = busy_operating_rooms_;
+  state.busy_surgeons = busy_surgeons_;
+  state.busy_recovery_beds = busy_recovery_beds_;
+  state.waiting_surgery = waiting_patients_.size();
+  state.waiting_recovery = recovery_waiting_.size() - recovery_head_;
+  state.pending_events = events_.size();
+  state.resident_patients = patients_.size();
+  return state;
+}
+
+ResourceCapacity Simulation::capacity() const {
+  return {config_.operating_rooms, config_.surgeon_count,
+          config_.recovery_beds};
+}
+
+void Simulation::set_capacity(const ResourceCapacity &capacity, double at) {
+  // Evenements anterieurs au changement traites avec l'ancienne capacite :
+  // l'horloge ne passe jamais devant un evenement en attente.
+  run_until(at);
+  at = std::max(at, clock_);
+  // Capacite integree jusqu'au changement : les taux d'occupation restent
+  // rapportes a la capacite reellement ouverte.
+  const double until = std::min(at, horizon_minutes_);
+  if (until > capacity_changed_at_) {
+    const double elapsed = until - capacity_changed_at_;
+    room_capacity_minutes_ += config_.operating_rooms * elapsed;
+    surgeon_capacity_minutes_ += std::max(1, config_.surgeon_count) * elapsed;
+    bed_capacity_minutes_ += std::max(1, config_.recovery_beds) * elapsed;
+    capacity_changed_at_ = until;
+  }
+  config_.operating_rooms = capacity.operating_rooms;
+  config_.surgeon_count = capacity.surgeon_count;
+  config_.recovery_beds = capacity.recovery_beds;
+
+  // Run incremental en cours : les patients en attente profitent aussitot
+  // d'une ressource ouverte
+  if (live_step_) {
+    advance_clock(at);
+    (this->*live_reschedule_)(at);
+  }
+}
+
+SimulationReport Simulation::report() const {
+  SimulationReport report;
+  report.patients_arrived = patients_arrived_;
+  report.urgent_arrived = urgent_arrived_;
+  report.elective_arrived = elective_arrived_;
+  // Un profiler peut faire passer le run par l'instance instrumentee : les
+  // compteurs ne sont publies que s'ils ont ete demandes
+  if (config_.collect_stats) {
+    report.engine = stats_;
+  }
+
+  report.patients_operated = static_cast<int>(wait_to_surgery_.count);
+  report.patients_completed = static_cast<int>(time_in_system_.count);
+  report.average_wait_to_surgery = wait_to_surgery_.mean;
+  report.max_wait_to_surgery = std::max(0.0, wait_to_surgery_.max);
+  report.average_wait_to_recovery = wait_to_recovery_.mean;
+  report.average_total_time_in_system = time_in_system_.mean;
+  report.operations_delayed = operations_delayed_;
+
+  // --- Calcul des Annulations ---
+  // Les patients "Annulés" sont ceux qui restent en attente (pending_waiting)
+  report.pending_waiting =
+      std::max(0, patients_arrived_ - report.patients_operated);
+  report.operations_cancelled = report.pending_waiting;
 
-  const double denominator_or = horizon_minutes_ * config_.operating_rooms;
+  // Capacite integree sur l'horizon (changements en cours de run compris) ;
+  // en cours de run, sur le temps ecoule.
+  const double until = run_finished_ ? horizon_minutes_ : clock_;
+  const double remaining = std::max(0.0, until - capacity_changed_at_);
+  const double denominator_or =
+      room_capacity_minutes_ + remaining * config_.operating_rooms;
   const double denominator_recovery =
-      horizon_minutes_ * std::max(1, config_.recovery_beds);
+      bed_capacity_minutes_ + remaining * std::max(1, config_.recovery_beds);
   if (denominator_or > 0.0) {
     report.operating_room_utilization =
         std::min(1.0, operating_room_busy_minutes_ / denominator_or);
@@ -382,12 +766,14 @@ SimulationReport Simulation::run() {
     report.recovery_bed_utilization =
         std::min(1.0, recovery_busy_minutes_ / denominator_recovery);
   }
-  if (config_.horizon_hours > 0.0) {
+  const double hours = run_finished_ ? config_.horizon_hours : clock_ / 60.0;
+  if (hours > 0.0) {
     report.throughput_per_hour =
-        static_cast<double>(patients_recovered) / config_.horizon_hours;
+        static_cast<double>(report.patients_completed) / hours;
   }
   const double denominator_surgeon =
-      horizon_minutes_ * std::max(1, config_.surgeon_count);
+      surgeon_capacity_minutes_ +
+      remaining * std::max(1, config_.surgeon_count);
   if (denominator_surgeon > 0.0) {
     report.surgeon_utilization =
         std::min(1.0, surgeon_busy_minutes_ / denominator_surgeon);
@@ -0,0 +1,67 @@
+#include "core/statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void RunningStat::add(double value) {
+  ++count;
+  if (count == 1) {
+    min = value;
+    max = value;
+  } else {
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+  const double delta = value - mean;
+  mean += delta / static_cast<double>(count);
+  m2 += delta * (value - mean);
+}
+
+void RunningStat::merge(const RunningStat &other) {
+  if (other.count == 0)
+    return;
+  if (count == 0) {
+    *this = other;
+    return;
+  }
+  const double n_a = static_cast<double>(count);
+  const double n_b = static_cast<double>(other.count);
+  const double n = n_a + n_b;
+  const double delta = other.mean - mean;
+  mean += delta * n_b / n;
+  m2 += other.m2 + delta * delta * n_a * n_b / n;
+  count += other.count;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+}
+
+double RunningStat::variance() const {
+  return (count > 1) ? m2 / static_cast<double>(count - 1) : 0.0;
+}
+
+double RunningStat::stddev() const { return std::sqrt(variance()); }
+
+double RunningStat::ci95_half_width() const {
+  if (count < 2)
+    return 0.0;
+  return student_t_975(count - 1) * stddev() /
+         std::sqrt(static_cast<double>(count));
+}
+
+double student_t_975(std::int64_t degrees_of_freedom) {
+  static const double table[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (degrees_of_freedom < 1)
+    return 0.0;
+  if (degrees_of_freedom <= 30)
+    return table[degrees_of_freedom - 1];
+  // Developpement de Cornish-Fisher autour du quantile normal.
+  const double z = 1.959963984540054;
+  const double df = static_cast<double>(degrees_of_freedom);
+  const double z3 = z * z * z;
+  const double z5 = z3 * z * z;
+  return z + (z3 + z) / (4.0 * df) +
+         (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+}
@@ -0,0 +1,337 @@
+#include "core/sweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "core/work_stealing.h"
+
+namespace {
+
+struct IntField {
+  const char *name;
+  int SimulationConfig::*member;
+};
+
+struct DoubleField {
+  const char *name;
+  double SimulationConfig::*member;
+};
+
+const IntField kIntFields[] = {
+    {"operating_rooms", &SimulationConfig::operating_rooms},
+    {"recovery_beds", &SimulationConfig::recovery_beds},
+    {"surgeon_count", &SimulationConfig::surgeon_count},
+    {"elective_patients", &SimulationConfig::elective_patients},
+};
+
+const DoubleField kDoubleFields[] = {
+    {"horizon_hours", &SimulationConfig::horizon_hours},
+    {"elective_window_hours", &SimulationConfig::elective_window_hours},
+    {"urgent_rate_per_hour", &SimulationConfig::urgent_rate_per_hour},
+    {"cleaning_time_minutes", &SimulationConfig::cleaning_time_minutes},
+    {"mean_surgery_minutes_elective",
+     &SimulationConfig::mean_surgery_minutes_elective},
+    {"mean_surgery_minutes_urgent",
+     &SimulationConfig::mean_surgery_minutes_urgent},
+    {"mean_recovery_minutes", &SimulationConfig::mean_recovery_minutes},
+    {"duration_cv", &SimulationConfig::duration_cv},
+};
+
+// FNV-1a 64 bits, applique a une description textuelle de la definition.
+struct Fnv1a {
+  std::uint64_t hash = 14695981039346656037ull;
+
+  void add(const std::string &text) {
+    for (unsigned char c : text) {
+      hash ^= c;
+      hash *= 1099511628211ull;
+    }
+    hash ^= 0xff; // separateur : "ab"+"c" != "a"+"bc"
+    hash *= 1099511628211ull;
+  }
+  // Valeur exacte (hexadecimal flottant), independante de la locale.
+  void add(double value) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%a", value);
+    add(std::string(text));
+  }
+};
+
+int as_integer(const std::string &field, double value) {
+  if (value != std::floor(value) || value < 0.0) {
+    throw std::invalid_argument("Valeur entiere attendue pour " + field);
+  }
+  return static_cast<int>(value);
+}
+
+// Etat d'un point en cours : rapports indexes par replication, alloues a la
+// premiere replication lancee et liberes a l'emission.
+struct PointState {
+  std::mutex mutex;
+  std::vector<SimulationReport> reports;
+  AllocationStats memory;
+  int done = 0;
+};
+
+} // namespace
+
+void set_config_field(SimulationConfig &config, const std::string &field,
+                      double value) {
+  for (const IntField &f : kIntFields) {
+    if (field == f.name) {
+      config.*f.member = as_integer(field, value);
+      return;
+    }
+  }
+  for (const DoubleField &f : kDoubleFields) {
+    if (field == f.name) {
+      config.*f.member = value;
+      return;
+    }
+  }
+  if (field == "policy") {
+    const int index = as_integer(field, value);
+    if (index > static_cast<int>(SchedulingPolicy::Balanced))
+      throw std::invalid_argument("Politique inconnue (0, 1 ou 2)");
+    config.policy = static_cast<SchedulingPolicy>(index);
+    return;
+  }
+  throw std::invalid_argument("Champ de configuration inconnu : " + field);
+}
+
+double config_field(const SimulationConfig &config, const std::string &field) {
+  for (const IntField &f : kIntFields) {
+    if (field == f.name)
+      return config.*f.member;
+  }
+  for (const DoubleField &f : kDoubleFields) {
+    if (field == f.name)
+      return config.*f.member;
+  }
+  if (field == "policy")
+    return static_cast<double>(static_cast<int>(config.policy));
+  throw std::invalid_argument("Champ de configuration inconnu : " + field);
+}
+
+SweepAxis SweepAxis::range(std::string field, double first, double last,
+                           double step) {
+  if (!(step > 0.0) || last < first) {
+    throw std::invalid_argument("Plage de balayage invalide pour " + field);
+  }
+  SweepAxis axis;
+  axis.field = std::move(field);
+  // Nombre de pas calcule une fois : pas d'accumulation d'erreurs d'arrondi.
+  const std::size_t count =
+      static_cast<std::size_t>(std::floor((last - first) / step + 1e-9)) + 1;
+  axis.values.reserve(count);
+  for (std::size_t k = 0; k < count; ++k)
+    axis.values.push_back(first + static_cast<double>(k) * step);
+  return axis;
+}
+
+SweepAxis SweepAxis::parse(const std::string &spec) {
+  const std::size_t equal = spec.find('=');
+  if (equal == std::string::npos || equal == 0 || equal + 1 == spec.size()) {
+    throw std::invalid_argument("Axe de balayage mal forme : " + spec);
+  }
+  const std::string field = spec.substr(0, equal);
+  const std::string rest = spec.substr(equal + 1);
+  const char separator = rest.find(':') != std::string::npos ? ':' : ',';
+
+  std::vector<double> numbers;
+  std::size_t start = 0;
+  while (start <= rest.size()) {
+    const std::size_t end = std::min(rest.find(separator, start), rest.size());
+    const std::string token = rest.substr(start, end - start);
+    std::size_t used = 0;
+    double value = 0.0;
+    try {
+      value = std::stod(token, &used);
+    } catch (const std::exception &) {
+      used = 0;
+    }
+    if (token.empty() || used != token.size()) {
+      throw std::invalid_argument("Valeur de balayage invalide : " + spec);
+    }
+    numbers.push_back(value);
+    start = end + 1;
+  }
+
+  if (separator == ':') {
+    if (numbers.size() != 3)
+      throw std::invalid_argument("Plage attendue debut:fin:pas : " + spec);
+    return range(field, numbers[0], numbers[1], numbers[2]);
+  }
+  SweepAxis axis;
+  axis.field = field;
+  axis.values = std::move(numbers);
+  return axis;
+}
+
+void SweepDefinition::validate() const {
+  if (replications <= 0)
+    throw std::invalid_argument("Le balayage demande au moins 1 replication");
+  SimulationConfig probe = base;
+  for (const SweepAxis &axis : axes) {
+    if (axis.values.empty())
+      throw std::invalid_argument("Axe de balayage vide : " + axis.field);
+    for (double value : axis.values)
+      set_config_field(probe, axis.field, value);
+    if (mode == SweepMode::List &&
+        axis.values.size() != axes.front().values.size()) {
+      throw std::invalid_argument(
+          "Mode liste : tous les axes doivent avoir la meme longueur");
+    }
+  }
+}
+
+std::size_t SweepDefinition::point_count() const {
+  if (axes.empty())
+    return 1;
+  if (mode == SweepMode::List)
+    return axes.front().values.size();
+  std::size_t count = 1;
+  for (const SweepAxis &axis : axes)
+    count *= axis.values.size();
+  return count;
+}
+
+std::vector<double> SweepDefinition::point_values(std::size_t point) const {
+  std::vector<double> values(axes.size());
+  if (mode == SweepMode::List) {
+    for (std::size_t a = 0; a < axes.size(); ++a)
+      values[a] = axes[a].values[point];
+    return values;
+  }
+  // Numeration en base mixte, dernier axe le plus rapide.
+  for (std::size_t a = axes.size(); a-- > 0;) {
+    const std::size_t size = axes[a].values.size();
+    values[a] = axes[a].values[point % size];
+    point /= size;
+  }
+  return values;
+}
+
+std::string SweepDefinition::fingerprint() const {
+  Fnv1a fnv;
+  for (const IntField &f : kIntFields) {
+    fnv.add(f.name);
+    fnv.add(static_cast<double>(base.*f.member));
+  }
+  for (const DoubleField &f : kDoubleFields) {
+    fnv.add(f.name);
+    fnv.add(base.*f.member);
+  }
+  fnv.add(config_field(base, "policy"));
+  fnv.add(static_cast<double>(base.seed));
+  fnv.add(mode == SweepMode::Grid ? "grid" : "list");
+  fnv.add(static_cast<double>(replications));
+  for (const SweepAxis &axis : axes) {
+    fnv.add(axis.field);
+    for (double value : axis.values)
+      fnv.add(value);
+  }
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016llx",
+                static_cast<unsigned long long>(fnv.hash));
+  return text;
+}
+
+SimulationConfig SweepDefinition::point_config(std::size_t point) const {
+  SimulationConfig config = base;
+  const std::vector<double> values = point_values(point);
+  for (std::size_t a = 0; a < axes.size(); ++a)
+    set_config_field(config, axes[a].field, values[a]);
+  config.trace_events = false;
+  return config;
+}
+
+SweepRunner::SweepRunner(SweepDefinition definition, int threads)
+    : definition_(std::move(definition)) {
+  definition_.validate();
+  if (threads <= 0)
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  threads_ = std::max(1, threads);
+}
+
+std::size_t SweepRunner::run(SweepSink &sink,
+                             const std::vector<std::size_t> &completed) {
+  const std::size_t total = definition_.point_count();
+  std::vector<bool> skip(total, false);
+  for (std::size_t point : completed) {
+    if (point < total)
+      skip[point] = true;
+  }
+  std::vector<std::size_t> pending;
+  for (std::size_t point = 0; point < total; ++point) {
+    if (!skip[point])
+      pending.push_back(point);
+  }
+
+  const int replications = definition_.replications;
+  std::vector<RandomStreams> streams;
+  streams.reserve(replications);
+  ReplicationStreams generator(definition_.base.seed);
+  for (int r = 0; r < replications; ++r)
+    streams.push_back(generator.next());
+
+  // Tache j : point pending[j / R], replication j % R. Les replications d'un
+  // meme point sont voisines, donc le plus souvent sur le meme thread.
+  const std::size_t jobs =
+      pending.size() * static_cast<std::size_t>(replications);
+  // Pas plus de moteurs que de taches restantes (reprise presque terminee)
+  const int workers = static_cast<int>(
+      std::min<std::size_t>(static_cast<std::size_t>(threads_), jobs));
+
+  std::unique_ptr<PointState[]> states(new PointState[pending.size()]);
+  std::vector<Simulation> engines(workers, Simulation(definition_.base));
+  std::mutex sink_mutex;
+
+  parallel_for_stealing(jobs, workers, [&](int worker, std::size_t job) {
+    const std::size_t slot = job / replications;
+    const int replication = static_cast<int>(job % replications);
+    const std::size_t point = pending[slot];
+    PointState &state = states[slot];
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (state.reports.empty())
+        state.reports.resize(replications);
+    }
+
+    Simulation &engine = engines[worker];
+    SimulationReport report;
+    AllocationStats memory;
+    {
+      AllocationScope scope(definition_.memory_budget);
+      engine.reset(definition_.point_config(point), streams[replication]);
+      report = engine.run();
+      if (definition_.track_memory)
+        memory = scope.stats();
+    }
+
+    SweepPointResult result;
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.reports[replication] = report;
+      state.memory.merge(memory);
+      if (++state.done < replications)
+        return;
+      // Meme reduction que ReplicationRunner::run()
+      for (const SimulationReport &r : state.reports)
+        result.summary.merge(ReplicationSummary::single(r));
+      result.memory = state.memory;
+      std::vector<SimulationReport>().swap(state.reports);
+    }
+    result.point = point;
+    result.values = definition_.point_values(point);
+    std::lock_guard<std::mutex> lock(sink_mutex);
+    sink.write_point(result);
+  });
+  return pending.size();
+}
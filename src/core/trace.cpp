@@ -0,0 +1,36 @@
+#include "core/trace.h"
+
+#include <iomanip>
+#include <sstream>
+
+std::string format_minutes(double minutes) {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1) << minutes;
+  return os.str();
+}
+
+std::string format_trace_message(const TraceRecord &record) {
+  const std::string id = std::to_string(record.patient_id);
+  const bool urgent = record.patient_type == PatientType::Urgent;
+  switch (record.kind) {
+  case TraceKind::Arrival:
+    return "Patient " + id +
+           (urgent ? " arrive (urgence)" : " arrive (programme)");
+  case TraceKind::SurgeryStart:
+    return "Debut chirurgie patient " + id + ". (Chirurgien occupe : " +
+           std::to_string(record.busy_surgeons) + "/" +
+           std::to_string(record.surgeon_count) + ")" +
+           (urgent ? " (urgence)" : " (programme)");
+  case TraceKind::SurgeryEnd:
+    return "Fin chirurgie patient " + id +
+           ". Chirurgien libere. Debut nettoyage (" +
+           format_minutes(record.cleaning_minutes) + " min)";
+  case TraceKind::CleaningEnd:
+    return "Nettoyage termine apres patient " + id + ". Salle libre.";
+  case TraceKind::RecoveryStart:
+    return "Debut reveil patient " + id;
+  case TraceKind::RecoveryEnd:
+    return "Fin reveil patient " + id;
+  }
+  return std::string();
+}
@@ -0,0 +1,106 @@
+#include "core/variates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+// Taille des blocs de travail (tient dans le cache L1).
+constexpr std::size_t kBlock = 256;
+
+} // namespace
+
+void fill_uniform_open(Xoshiro256PlusPlus &rng, double *out, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = (static_cast<double>(rng() >> 11) + 0.5) * 0x1.0p-53;
+}
+
+void fill_standard_normal(Xoshiro256PlusPlus &rng, double *out,
+                          std::size_t n) {
+  double u1[kBlock];
+  double u2[kBlock];
+  std::size_t done = 0;
+  while (done < n) {
+    const std::size_t pairs = std::min(kBlock, (n - done + 1) / 2);
+    fill_uniform_open(rng, u1, pairs);
+    fill_uniform_open(rng, u2, pairs);
+    // Passe de transformation : calcul identique sur chaque case.
+    for (std::size_t i = 0; i < pairs; ++i) {
+      const double radius = std::sqrt(-2.0 * std::log(u1[i]));
+      const double angle = kTwoPi * u2[i];
+      u1[i] = radius * std::cos(angle);
+      u2[i] = radius * std::sin(angle);
+    }
+    for (std::size_t i = 0; i < pairs && done < n; ++i) {
+      out[done++] = u1[i];
+      if (done < n)
+        out[done++] = u2[i];
+    }
+  }
+}
+
+void fill_exponential(Xoshiro256PlusPlus &rng, double rate, double *out,
+                      std::size_t n) {
+  fill_uniform_open(rng, out, n);
+  const double scale = -1.0 / rate;
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = scale * std::log(out[i]);
+}
+
+void fill_truncated_normal(Xoshiro256PlusPlus &rng, double mean,
+                           double stddev, double lower, double fallback,
+                           double *out, std::size_t n) {
+  fill_standard_normal(rng, out, n);
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = mean + stddev * out[i];
+
+  // Passe de correction (rare) : nouveaux tirages pour les valeurs rejetees.
+  // Les normales sont tirees par paires ; la seconde sert au tirage suivant.
+  double pair[2];
+  bool spare = false;
+  for (std::size_t i = 0; i < n; ++i) {
+    int guard = 1;
+    while (out[i] <= lower && guard < 16) {
+      if (!spare)
+        fill_standard_normal(rng, pair, 2);
+      out[i] = mean + stddev * pair[spare ? 1 : 0];
+      spare = !spare;
+      ++guard;
+    }
+    if (out[i] <= lower)
+      out[i] = fallback;
+  }
+}
+
+void TruncatedNormalSampler::reset(double mean, double stddev, double lower,
+                                   double fallback, std::size_t chunk) {
+  mean_ = mean;
+  stddev_ = stddev;
+  lower_ = lower;
+  fallback_ = fallback;
+  chunk_ = std::max<std::size_t>(1, chunk);
+  buffer_.clear();
+  next_ = 0;
+}
+
+void TruncatedNormalSampler::refill(Xoshiro256PlusPlus &rng) {
+  buffer_.resize(chunk_);
+  fill_truncated_normal(rng, mean_, stddev_, lower_, fallback_,
+                        buffer_.data(), chunk_);
+  next_ = 0;
+}
+
+void ExponentialSampler::reset(double rate, std::size_t chunk) {
+  rate_ = rate;
+  chunk_ = std::max<std::size_t>(1, chunk);
+  buffer_.clear();
+  next_ = 0;
+}
+
+void ExponentialSampler::refill(Xoshiro256PlusPlus &rng) {
+  buffer_.resize(chunk_);
+  fill_exponential(rng, rate_, buffer_.data(), chunk_);
+  next_ = 0;
+}
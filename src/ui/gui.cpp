@@ -17,15 +17,37 @@
 #include <QSignalBlocker>
 #include <QSplitter>
 #include <QString>
+#include <QStringList>
 #include <QVBoxLayout>
 #include <QVariant>
 
+#include <algorithm>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 
 SimulationWindow::SimulationWindow(QWidget *parent) : QWidget(parent) {
   setObjectName("root");
+  calcul_ = new SimulationTask(this);
   construire_ui();
+
+  // Progression du calcul en temps simulé, affichée sur le bouton
+  connect(calcul_, &SimulationTask::progression, this,
+          [this](double minutes, double horizon) {
+            const int pourcent =
+                horizon > 0.0
+                    ? static_cast<int>(std::min(1.0, minutes / horizon) * 100)
+                    : 100;
+            bouton_simuler_->setText(
+                QString("Calcul en cours... %1 %").arg(pourcent));
+          });
+  connect(calcul_, &SimulationTask::echec, this,
+          [this](const QString &message) {
+            bouton_simuler_->setEnabled(true);
+            bouton_simuler_->setText("Lancer la simulation");
+            QMessageBox::warning(this, "Erreur",
+                                 "La simulation a échoué : " + message);
+          });
 }
 
 QLabel *creer_titre_section(const QString &texte) {
@@ -349,7 +371,20 @@ void SimulationWindow::construire_ui() {
   connect(bouton_exporter_, &QPushButton::clicked, this,
           &SimulationWindow::exporter_csv);
 
+  // Paramètres modifiés pendant un calcul : le run en cours est abandonné
+  for (QSpinBox *champ : {ors_, chirurgiens_, lits_reveil_, nb_programmes_})
+    connect(champ, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &SimulationWindow::annuler_calcul);
+  for (QDoubleSpinBox *champ :
+       {horizon_, fenetre_programmes_, taux_urgences_, duree_prog_,
+        duree_urgence_, duree_reveil_, duree_nettoyage_})
+    connect(champ, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this,
+            &SimulationWindow::annuler_calcul);
+  connect(politique_, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, &SimulationWindow::annuler_calcul);
+
   connect(bouton_retour_, &QPushButton::clicked, this, [this]() {
+    annuler_calcul();
     reset_interface();
     emit retourAccueil();
   });
@@ -397,7 +432,7 @@ void SimulationWindow::reset_interface() {
   val_annule_->setText("-");
 
   // 4. Vider les données stockées
-  derniers_patients_.clear();
+  derniere_simulation_.reset();
   // On garde la config par défaut (champs spinbox) pour ne pas frustrer
   // l'utilisateur, mais on pourrait aussi les remettre aux valeurs par défaut
   // si voulu.
@@ -512,6 +547,8 @@ void SimulationWindow::afficher_rapport(const SimulationConfig &config,
 }
 
 void SimulationWindow::exporter_csv() {
+  if (!derniere_simulation_)
+    return;
   QString filename = QFileDialog::getSaveFileName(
       this, "Sauvegarder les résultats", "simulation_data.csv",
       "Fichiers CSV (*.csv)");
@@ -558,16 +595,19 @@ void SimulationWindow::exporter_csv() {
   out << "ID;Type;Arrivee (min);Debut Chir (min);Fin Chir (min);Attente "
          "(min);Statut\n";
 
-  for (const auto &p : derniers_patients_) {
-    out << p.id << ";";
-    out << (p.type == PatientType::Urgent ? "Urgent" : "Programme") << ";";
-    out << QString::number(p.arrival_time, 'f', 2) << ";";
-
-    if (p.start_surgery_time >= 0) {
-      out << QString::number(p.start_surgery_time, 'f', 2) << ";";
-      out << QString::number(p.end_surgery_time, 'f', 2) << ";";
-      out << QString::number(p.start_surgery_time - p.arrival_time, 'f', 2)
-          << ";";
+  const PatientTable &patients = derniere_simulation_->get_patients();
+  for (size_t i = 0; i < patients.size(); ++i) {
+    const double arrivee = patients.arrival_time[i];
+    const double debut = patients.start_surgery_time[i];
+    out << patients.id[i] << ";";
+    out << (patients.type[i] == PatientType::Urgent ? "Urgent" : "Programme")
+        << ";";
+    out << QString::number(arrivee, 'f', 2) << ";";
+
+    if (debut >= 0) {
+      out << QString::number(debut, 'f', 2) << ";";
+      out << QString::number(patients.end_surgery_time[i], 'f', 2) << ";";
+      out << QString::number(debut - arrivee, 'f', 2) << ";";
       out << "Operé";
     } else {
       out << "-;-;-;Annulé";
@@ -590,20 +630,61 @@ void SimulationWindow::lancer_simulation() {
   }
 
   SimulationConfig config = lire_config();
-  Simulation simulation(config);
-
-  if (config.trace_events) {
+  if (config.trace_events)
     trace_->clear();
-    simulation.set_log_sink(
-        [this](const std::string &msg, double t) { afficher_trace(msg, t); });
-  }
-
-  SimulationReport report = simulation.run();
 
-  dernier_config_ = config;
-  dernier_rapport_ = report;
-  derniers_patients_ = simulation.get_patients();
-  bouton_exporter_->setEnabled(true);
+  // Le run et la mise en forme de la trace se font sur un thread du pool ;
+  // le moteur (et ses patients) est ensuite remis tel quel à la fenêtre.
+  struct RunCalcule {
+    std::unique_ptr<Simulation> simulation;
+    SimulationReport rapport;
+    QString trace;
+  };
+  auto calcul = std::make_shared<RunCalcule>();
+
+  auto travail = [config, calcul](RunControl &controle) {
+    auto simulation = std::make_unique<Simulation>(config);
+    TraceBuffer trace;
+    if (config.trace_events)
+      simulation->set_trace_sink(&trace);
+    simulation->set_run_control(&controle);
+    calcul->rapport = simulation->run();
+    simulation->set_trace_sink(nullptr);
+    simulation->set_run_control(nullptr);
+
+    QStringList lignes;
+    lignes.reserve(static_cast<int>(trace.records.size()));
+    for (const TraceRecord &record : trace.records)
+      lignes << QString("[t=%1 min] %2")
+                    .arg(record.time, 0, 'f', 1)
+                    .arg(QString::fromStdString(format_trace_message(record)));
+    calcul->trace = lignes.join('\n');
+    calcul->simulation = std::move(simulation);
+  };
+
+  auto fin = [this, config, calcul]() {
+    bouton_simuler_->setEnabled(true);
+    bouton_simuler_->setText("Lancer la simulation");
+    if (config.trace_events)
+      trace_->setPlainText(calcul->trace);
+
+    dernier_config_ = config;
+    dernier_rapport_ = calcul->rapport;
+    derniere_simulation_ = std::move(calcul->simulation);
+    bouton_exporter_->setEnabled(true);
+
+    afficher_rapport(config, dernier_rapport_);
+  };
+
+  bouton_simuler_->setEnabled(false);
+  bouton_simuler_->setText("Calcul en cours...");
+  calcul_->lancer(std::move(travail), std::move(fin));
+}
 
-  afficher_rapport(config, report);
+void SimulationWindow::annuler_calcul() {
+  if (!calcul_->en_cours())
+    return;
+  calcul_->annuler();
+  bouton_simuler_->setEnabled(true);
+  bouton_simuler_->setText("Lancer la simulation");
 }
@@ -0,0 +1,223 @@
+#include "ui/patient_model.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+#include <algorithm>
+
+namespace {
+
+QString texte_etat(ReplayState etat) {
+  switch (etat) {
+  case ReplayState::NotArrived:
+    return "Pas arrivé";
+  case ReplayState::Waiting:
+  case ReplayState::Unscheduled:
+    return "EN ATTENTE BLOC";
+  case ReplayState::Cancelled:
+    return "🚫 ANNULÉ";
+  case ReplayState::InSurgery:
+    return "🔴 AU BLOC OP";
+  case ReplayState::AwaitingBed:
+    return "⏳ ATTENTE LIT";
+  case ReplayState::InRecovery:
+    return "🔵 EN RÉVEIL";
+  case ReplayState::Discharged:
+    return "✅ SORTI";
+  }
+  return QString();
+}
+
+QColor couleur_etat(ReplayState etat) {
+  switch (etat) {
+  case ReplayState::NotArrived:
+    return QColor("#94a3b8"); // Gris
+  case ReplayState::Waiting:
+  case ReplayState::Unscheduled:
+    return QColor("#f97316"); // Orange
+  case ReplayState::Cancelled:
+    return QColor("#64748b"); // Gris Ardoise
+  case ReplayState::InSurgery:
+    return QColor("#2563eb"); // Bleu vif
+  case ReplayState::AwaitingBed:
+    return QColor("#d97706"); // Ambre
+  case ReplayState::InRecovery:
+    return QColor("#8b5cf6");
+  case ReplayState::Discharged:
+    return QColor("#10b981"); // Vert
+  }
+  return QColor();
+}
+
+bool en_attente(ReplayState etat) {
+  return etat == ReplayState::Waiting || etat == ReplayState::Unscheduled ||
+         etat == ReplayState::Cancelled;
+}
+
+} // namespace
+
+PatientTableModel::PatientTableModel(QObject *parent)
+    : QAbstractTableModel(parent) {}
+
+void PatientTableModel::definir_scenario(const PatientTable *patients,
+                                         const ReplayCursor *replay) {
+  beginResetModel();
+  patients_ = patients;
+  replay_ = replay;
+  temps_ = 0.0;
+  endResetModel();
+}
+
+void PatientTableModel::notifier_rejeu(double temps_minutes) {
+  temps_ = temps_minutes;
+  if (!replay_)
+    return;
+
+  // Lignes changées + lignes dont l'attente avance, triées puis regroupées
+  // en plages : un signal par plage, pas par patient
+  lignes_.assign(replay_->changed_rows().begin(),
+                 replay_->changed_rows().end());
+  lignes_.insert(lignes_.end(), replay_->waiting_rows().begin(),
+                 replay_->waiting_rows().end());
+  std::sort(lignes_.begin(), lignes_.end());
+  lignes_.erase(std::unique(lignes_.begin(), lignes_.end()), lignes_.end());
+
+  for (size_t debut = 0; debut < lignes_.size();) {
+    size_t fin = debut;
+    while (fin + 1 < lignes_.size() && lignes_[fin + 1] == lignes_[fin] + 1)
+      ++fin;
+    emit dataChanged(index(static_cast<int>(lignes_[debut]), ColEtat),
+                     index(static_cast<int>(lignes_[fin]), ColAttente));
+    debut = fin + 1;
+  }
+}
+
+int PatientTableModel::rowCount(const QModelIndex &parent) const {
+  if (parent.isValid() || !patients_)
+    return 0;
+  return static_cast<int>(patients_->size());
+}
+
+int PatientTableModel::columnCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : NbColonnes;
+}
+
+double PatientTableModel::attente(int ligne) const {
+  const ReplayState etat = replay_->state(ligne);
+  const double arrivee = patients_->arrival_time[ligne];
+  if (etat == ReplayState::NotArrived)
+    return -1.0;
+  // En attente : l'attente court ; opéré : attente finale figée
+  if (en_attente(etat))
+    return temps_ - arrivee;
+  return patients_->start_surgery_time[ligne] - arrivee;
+}
+
+QVariant PatientTableModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || !patients_)
+    return QVariant();
+  const int ligne = index.row();
+  const ReplayState etat = replay_->state(ligne);
+
+  if (role == RoleValeur) {
+    switch (index.column()) {
+    case ColId:
+      return patients_->id[ligne];
+    case ColType:
+      return static_cast<int>(patients_->type[ligne]);
+    case ColArrivee:
+      return static_cast<double>(patients_->arrival_time[ligne]);
+    case ColEtat:
+      return static_cast<int>(etat);
+    case ColAttente:
+      return attente(ligne);
+    }
+    return QVariant();
+  }
+
+  if (role == Qt::DisplayRole) {
+    switch (index.column()) {
+    case ColId:
+      return QString::number(patients_->id[ligne]);
+    case ColType:
+      return patients_->type[ligne] == PatientType::Urgent ? "URGENCE"
+                                                           : "Programmé";
+    case ColArrivee:
+      return QString::number(patients_->arrival_time[ligne], 'f', 1) + " min";
+    case ColEtat:
+      return texte_etat(etat);
+    case ColAttente: {
+      const double minutes = attente(ligne);
+      return minutes < 0 ? QString("-")
+                         : QString::number(minutes, 'f', 0) + " min";
+    }
+    }
+    return QVariant();
+  }
+
+  if (role == Qt::ForegroundRole) {
+    if (index.column() == ColType &&
+        patients_->type[ligne] == PatientType::Urgent)
+      return QBrush(QColor("#ef4444")); // Rouge
+    if (index.column() == ColEtat)
+      return QBrush(couleur_etat(etat));
+    return QVariant();
+  }
+
+  if (role == Qt::FontRole && index.column() == ColEtat &&
+      etat != ReplayState::NotArrived) {
+    static const QFont police_gras("Segoe UI", 9, QFont::Bold);
+    static const QFont police_normale("Segoe UI", 9, QFont::Normal);
+    return etat == ReplayState::Discharged ? police_normale : police_gras;
+  }
+  return QVariant();
+}
+
+QVariant PatientTableModel::headerData(int section,
+                                       Qt::Orientation orientation,
+                                       int role) const {
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    return QVariant();
+  switch (section) {
+  case ColId:
+    return "ID";
+  case ColType:
+    return "Type";
+  case ColArrivee:
+    return "Arrivée";
+  case ColEtat:
+    return "État Actuel";
+  case ColAttente:
+    return "Attente/Retard";
+  }
+  return QVariant();
+}
+
+PatientFilterModel::PatientFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent) {
+  // Tri numérique sur les valeurs brutes, pas sur le texte affiché
+  setSortRole(PatientTableModel::RoleValeur);
+  setDynamicSortFilter(true);
+}
+
+void PatientFilterModel::definir_filtre(Filtre filtre) {
+  filtre_ = filtre;
+  invalidateFilter();
+}
+
+bool PatientFilterModel::filterAcceptsRow(int source_row,
+                                          const QModelIndex &) const {
+  const auto *modele = static_cast<const PatientTableModel *>(sourceModel());
+  switch (filtre_) {
+  case Filtre::Tous:
+    return true;
+  case Filtre::Urgences:
+    return modele->type(source_row) == PatientType::Urgent;
+  case Filtre::EnAttente: {
+    const ReplayState etat = modele->etat(source_row);
+    return etat == ReplayState::Waiting || etat == ReplayState::Unscheduled;
+  }
+  }
+  return true;
+}
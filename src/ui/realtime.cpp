@@ -1,4 +1,5 @@
 #include "ui/realtime.h"
+#include <QCheckBox>
 #include <QDateTime>
 #include <QDialog>
 #include <QDoubleSpinBox>
@@ -7,17 +8,51 @@
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QSpinBox>
+#include <QSignalBlocker>
 #include <QSplitter>
+#include <QStringList>
+#include <QTextCursor>
 #include <QTextStream>
 #include <QVBoxLayout>
 
 #include <QGraphicsDropShadowEffect>
 
 #include <algorithm>
+#include <memory>
+
+namespace {
+
+// Lignes du journal réaffichées après un saut dans la chronologie
+constexpr size_t kLignesConsole = 500;
+
+// Ligne du journal CSV : 12.5;Le patient arrive...
+// Un ";" dans le message est remplacé par "," pour ne pas casser la colonne
+QString ligne_csv(const TraceRecord &ev) {
+  QString message = QString::fromStdString(format_trace_message(ev));
+  message.replace(";", ",");
+  return QString::number(ev.time, 'f', 1) + ";" + message + "\n";
+}
+
+} // namespace
 
 RealTimeWindow::RealTimeWindow(QWidget *parent) : QWidget(parent) {
   timer_ = new QTimer(this);
   connect(timer_, &QTimer::timeout, this, &RealTimeWindow::tic_horloge);
+  calcul_ = new SimulationTask(this);
+  connect(calcul_, &SimulationTask::progression, this,
+          [this](double minutes, double horizon) {
+            if (horizon > 0.0)
+              barre_progression_->setValue(static_cast<int>(
+                  std::min(1.0, minutes / horizon) *
+                  RunControl::kProgressSteps));
+          });
+  connect(calcul_, &SimulationTask::echec, this,
+          [this](const QString &message) {
+            arreter_simulation();
+            QMessageBox::warning(this, "Erreur",
+                                 "Le calcul du scénario a échoué : " +
+                                     message);
+          });
   construire_ui();
 }
 
@@ -35,13 +70,8 @@ QFrame *RealTimeWindow::creer_carte(QWidget *parent) {
   return frame;
 }
 
-void RealTimeWindow::precalculer_scenario() {
-  // 1. On vide la queue précédente
-  events_queue_.clear();
-  current_event_index_ = 0;
-
-  // 2. On prépare une config (On pourrait ajouter des champs de config sur
-  // cette page plus tard)
+SimulationConfig RealTimeWindow::lire_config() const {
+  // On pourrait ajouter des champs de config sur cette page plus tard
   SimulationConfig config;
   config.horizon_hours = input_horizon_->value();
   config.operating_rooms = input_salles_->value();
@@ -59,60 +89,167 @@ void RealTimeWindow::precalculer_scenario() {
   // On met une seed aléatoire pour que chaque "Lecture" soit différente
   config.seed = static_cast<unsigned int>(QDateTime::currentMSecsSinceEpoch());
 
-  horizon_minutes_ = config.horizon_hours * 60.0;
+  return config;
+}
 
-  // 3. On crée la simulation
-  Simulation sim(config);
+void RealTimeWindow::demarrer_direct() {
+  SimulationConfig config = lire_config();
+  // Mode flux : seuls les patients actifs restent en mémoire
+  config.streaming = true;
+
+  direct_ = std::make_unique<Simulation>(config);
+  trace_direct_.records.clear();
+  direct_->set_trace_sink(&trace_direct_);
+  direct_->start();
+
+  // Évènements écrits dans un fichier temporaire pour l'export ; la console
+  // ne garde que les dernières lignes
+  journal_direct_ = std::make_unique<QTemporaryFile>();
+  if (!journal_direct_->open()) {
+    journal_direct_.reset();
+    log_console_->appendPlainText(
+        ">>> Journal temporaire indisponible : l'export sera vide.");
+  }
+  log_console_->setMaximumBlockCount(static_cast<int>(kLignesConsole));
 
-  // 4. L'ASTUCE EST ICI : On détourne le système de log
-  sim.set_log_sink([this](const std::string &msg, double t) {
-    // Au lieu d'afficher, on stocke !
-    events_queue_.push_back({t, msg});
-  });
+  // Pas de tableau ni de chronologie : rien n'est connu d'avance
+  modele_patients_->definir_scenario(nullptr, nullptr);
+  patients_snapshots_ = PatientTable();
+  replay_ = ReplayCursor();
+  events_queue_.clear();
+  current_event_index_ = 0;
+  horizon_minutes_ = config.horizon_hours * 60.0;
+  fin_effective_minutes_ = horizon_minutes_;
+  barre_progression_->setRange(0, static_cast<int>(horizon_minutes_));
+  barre_progression_->setValue(0);
+  curseur_temps_->setEnabled(false);
+  scenario_pret_ = true;
 
-  // 5. On lance le calcul (c'est instantané)
-  sim.run();
+  log_console_->appendPlainText(">>> Moteur en direct démarré.");
+  mettre_a_jour_kpi();
+}
 
-  patients_snapshots_ = sim.get_patients();
+void RealTimeWindow::tic_direct() {
+  direct_->run_until(temps_actuel_minutes_);
+
+  // Évènements produits pendant ce tic : affichés, puis écrits au journal
+  // d'export (rien n'est conservé en mémoire d'un tic à l'autre)
+  for (const TraceRecord &ev : trace_direct_.records) {
+    log_console_->appendPlainText(
+        QString("[t=%1 min] %2")
+            .arg(ev.time, 0, 'f', 1)
+            .arg(QString::fromStdString(format_trace_message(ev))));
+    if (journal_direct_)
+      journal_direct_->write(ligne_csv(ev).toUtf8());
+  }
+  trace_direct_.records.clear();
 
-  // Cela mélange programmes et urgences selon leur ordre d'apparition réel
-  std::sort(patients_snapshots_.begin(), patients_snapshots_.end(),
-            [](const Patient &a, const Patient &b) {
-              return a.arrival_time < b.arrival_time;
-            });
+  // Au-delà de l'horizon, la barre s'allonge avec les heures supplémentaires
+  if (temps_actuel_minutes_ > barre_progression_->maximum()) {
+    barre_progression_->setMaximum(static_cast<int>(temps_actuel_minutes_));
+    barre_progression_->setValue(static_cast<int>(temps_actuel_minutes_));
+  }
+  mettre_a_jour_kpi();
 
-  // On initialise le tableau (lignes vides)
-  table_patients_->setRowCount(patients_snapshots_.size());
-  for (size_t i = 0; i < patients_snapshots_.size(); ++i) {
-    const auto &p = patients_snapshots_[i];
+  const SimulationState etat = direct_->state();
+  const bool activite_en_cours = etat.busy_operating_rooms > 0 ||
+                                 etat.busy_recovery_beds > 0 ||
+                                 etat.waiting_recovery > 0;
+  if (temps_actuel_minutes_ >= horizon_minutes_ &&
+      (direct_->finished() || !activite_en_cours)) {
+    fin_effective_minutes_ = temps_actuel_minutes_;
+    terminer_simulation();
+  }
+}
 
-    // Colonne ID
-    table_patients_->setItem(i, 0, new QTableWidgetItem(QString::number(p.id)));
+void RealTimeWindow::changer_capacite() {
+  if (!direct_ || direct_->finished())
+    return;
+  const ResourceCapacity capacite{input_salles_->value(),
+                                  input_chirurgiens_->value(),
+                                  input_lits_->value()};
+  direct_->set_capacity(capacite, temps_actuel_minutes_);
+  log_console_->appendPlainText(
+      QString(">>> Capacité modifiée : %1 salles, %2 chirurgiens, %3 lits.")
+          .arg(capacite.operating_rooms)
+          .arg(capacite.surgeon_count)
+          .arg(capacite.recovery_beds));
+  mettre_a_jour_kpi();
+}
 
-    // Colonne Type (Avec couleur)
-    auto *itemType = new QTableWidgetItem(
-        p.type == PatientType::Urgent ? "URGENCE" : "Programmé");
-    if (p.type == PatientType::Urgent)
-      itemType->setForeground(QColor("#ef4444")); // Rouge
-    table_patients_->setItem(i, 1, itemType);
+void RealTimeWindow::precalculer_scenario() {
+  // 1. On vide la queue précédente (le tableau est détaché pendant le calcul)
+  modele_patients_->definir_scenario(nullptr, nullptr);
+  direct_.reset();
+  journal_direct_.reset();
+  log_console_->setMaximumBlockCount(0); // rejeu : journal complet
+  events_queue_.clear();
+  current_event_index_ = 0;
 
-    // Colonne Arrivée
-    table_patients_->setItem(
-        i, 2,
-        new QTableWidgetItem(QString::number(p.arrival_time, 'f', 1) + " min"));
+  // 2. On prépare une config
+  const SimulationConfig config = lire_config();
+  horizon_minutes_ = config.horizon_hours * 60.0;
+  scenario_pret_ = false;
+
+  // 3. Le moteur tourne sur un thread du pool : la table triée, le rejeu et
+  // le journal y sont aussi construits, puis déplacés (sans copie) dans la
+  // fenêtre une fois prêts.
+  struct ScenarioCalcule {
+    std::vector<TraceRecord> evenements;
+    PatientTable patients;
+    ReplayCursor replay;
+  };
+  auto calcul = std::make_shared<ScenarioCalcule>();
+  const double horizon = horizon_minutes_;
+
+  auto travail = [config, horizon, calcul](RunControl &controle) {
+    Simulation sim(config);
+
+    // 4. L'ASTUCE EST ICI : On détourne le système de trace
+    // Au lieu d'afficher, on stocke les évènements bruts (texte construit
+    // seulement quand ils sont affichés)
+    TraceBuffer trace;
+    sim.set_trace_sink(&trace);
+    sim.set_run_control(&controle);
+    sim.run();
+    calcul->evenements = std::move(trace.records);
+
+    // Optionnel : On s'assure que les évènements sont bien triés par ordre
+    // chronologique (Normalement le moteur le fait déjà, mais c'est plus sûr)
+    std::stable_sort(calcul->evenements.begin(), calcul->evenements.end(),
+                     [](const TraceRecord &a, const TraceRecord &b) {
+                       return a.time < b.time;
+                     });
+
+    // Cela mélange programmes et urgences selon leur ordre d'apparition réel
+    calcul->patients = sim.get_patients().sorted_by_arrival();
+    // Flux trié des changements d'état : chaque tic n'applique que les
+    // transitions franchies
+    calcul->replay = ReplayCursor(calcul->patients, horizon);
+  };
 
-    // Colonne État (Vide au début)
-    table_patients_->setItem(i, 3, new QTableWidgetItem("Pas encore arrivé"));
+  auto fin = [this, calcul]() {
+    events_queue_ = std::move(calcul->evenements);
+    patients_snapshots_ = std::move(calcul->patients);
+    replay_ = std::move(calcul->replay);
+    installer_scenario();
+    lancer_lecture();
+  };
 
-    // Colonne Retard (Vide au début)
-    table_patients_->setItem(i, 4, new QTableWidgetItem("-"));
-  }
+  // Pendant le calcul, la barre suit le temps simulé (en %)
+  barre_progression_->setRange(0, RunControl::kProgressSteps);
+  barre_progression_->setValue(0);
+  curseur_temps_->setEnabled(false);
+  btn_start_->setEnabled(false);
+  btn_pause_->setEnabled(false);
+  btn_stop_->setEnabled(true);
+  log_console_->appendPlainText(">>> Calcul du scénario en cours...");
+  calcul_->lancer(std::move(travail), std::move(fin));
+}
 
-  // Optionnel : On s'assure que les évènements sont bien triés par ordre
-  // chronologique (Normalement le moteur le fait déjà, mais c'est plus sûr)
-  std::sort(
-      events_queue_.begin(), events_queue_.end(),
-      [](const EventLog &a, const EventLog &b) { return a.time < b.time; });
+void RealTimeWindow::installer_scenario() {
+  // Le modèle lit directement les colonnes du scénario et l'état du rejeu
+  modele_patients_->definir_scenario(&patients_snapshots_, &replay_);
 
   // --- AJOUT : DÉTECTION DE LA FIN RÉELLE ---
   if (!events_queue_.empty()) {
@@ -129,6 +266,14 @@ void RealTimeWindow::precalculer_scenario() {
 
   // La barre va maintenant de 0 jusqu'à la fin réelle (ex: 10h)
   barre_progression_->setRange(0, static_cast<int>(fin_effective_minutes_));
+  barre_progression_->setValue(0);
+  {
+    const QSignalBlocker bloqueur(curseur_temps_);
+    curseur_temps_->setRange(0, static_cast<int>(fin_effective_minutes_));
+    curseur_temps_->setValue(0);
+  }
+  curseur_temps_->setEnabled(true);
+  scenario_pret_ = true;
 
   log_console_->appendPlainText(
       QString(">>> Scénario généré : %1 évènements prêts à être joués.")
@@ -178,67 +323,38 @@ void RealTimeWindow::basculer_edition_inputs(bool actif) {
 }
 
 void RealTimeWindow::mettre_a_jour_kpi() {
-  int count_attente = 0;
-  int count_bloc = 0;
-  int count_reveil = 0;
-  int count_sortis = 0;
-
-
-  int count_retard = 0;
-  int count_annule = 0;
-
-  for (const auto &p : patients_snapshots_) {
-    // Patient pas encore arrivé : on ignore
-    if (temps_actuel_minutes_ < p.arrival_time)
-      continue;
-
-    // 1. CALCUL DES ÉTATS (Attente, Bloc, Réveil, Sorti)
-    if (p.start_surgery_time < 0) {
-      // Cas spécial : Le patient est annulé
-      // On le compte comme "Annulé" dès qu'il est "arrivé" dans la simu
-      count_annule++;
-      continue; // On ne le compte pas dans "attente" ou autres
-    } else if (temps_actuel_minutes_ < p.start_surgery_time) {
-      count_attente++;
-    } else if (temps_actuel_minutes_ >= p.start_surgery_time &&
-               temps_actuel_minutes_ < p.end_surgery_time) {
-      count_bloc++;
-    } else if (p.start_recovery_time >= 0 &&
-               temps_actuel_minutes_ >= p.start_recovery_time &&
-               temps_actuel_minutes_ < p.end_recovery_time) {
-      count_reveil++;
-    } else if (p.end_recovery_time >= 0 &&
-               temps_actuel_minutes_ >= p.end_recovery_time) {
-      count_sortis++;
-    }
-
-    // 2. CALCUL DU RETARD (> 15 min)
-    // Le retard se calcule indépendamment de l'état actuel (c'est un cumulatif)
-    if (p.start_surgery_time >= 0) {
-      // Si l'opération a commencé (ou est finie), on connait le retard exact
-      if (temps_actuel_minutes_ >= p.start_surgery_time) {
-        if ((p.start_surgery_time - p.arrival_time) > 15.0) {
-          count_retard++;
-        }
-      }
-      // Si l'opération n'a PAS commencé (il attend), on regarde s'il attend
-      // DEPUIS trop longtemps
-      else {
-        if ((temps_actuel_minutes_ - p.arrival_time) > 15.0) {
-          count_retard++;
-        }
-      }
-    }
+  if (direct_) {
+    // Moteur en direct : état courant du moteur. Passé l'horizon, plus
+    // aucune chirurgie ne commence : les patients en attente sont annulés.
+    const SimulationState etat = direct_->state();
+    const SimulationReport bilan = direct_->report();
+    const bool horizon_atteint = temps_actuel_minutes_ >= horizon_minutes_;
+    const int en_attente = static_cast<int>(etat.waiting_surgery);
+    kpi_attente_->setText(QString::number(horizon_atteint ? 0 : en_attente));
+    kpi_au_bloc_->setText(QString::number(etat.busy_surgeons));
+    kpi_en_reveil_->setText(QString::number(etat.busy_recovery_beds));
+    kpi_sortis_->setText(QString::number(bilan.patients_completed));
+    kpi_retard_->setText(QString::number(bilan.operations_delayed));
+    kpi_annule_->setText(QString::number(horizon_atteint ? en_attente : 0));
+    return;
   }
 
-  
-  kpi_attente_->setText(QString::number(count_attente));
-  kpi_au_bloc_->setText(QString::number(count_bloc));
-  kpi_en_reveil_->setText(QString::number(count_reveil));
-  kpi_sortis_->setText(QString::number(count_sortis));
-
-  
-  kpi_retard_->setText(QString::number(count_retard));
+  // Compteurs tenus à jour par le rejeu : aucun parcours des patients.
+  // Un patient jamais opéré compte comme annulé dès son arrivée.
+  const int count_annule = replay_.count(ReplayState::Unscheduled) +
+                           replay_.count(ReplayState::Cancelled);
+
+  kpi_attente_->setText(
+      QString::number(replay_.count(ReplayState::Waiting)));
+  kpi_au_bloc_->setText(
+      QString::number(replay_.count(ReplayState::InSurgery)));
+  kpi_en_reveil_->setText(
+      QString::number(replay_.count(ReplayState::InRecovery)));
+  kpi_sortis_->setText(
+      QString::number(replay_.count(ReplayState::Discharged)));
+
+  // Retard (> 15 min) : cumulatif, attente en cours ou attente finale
+  kpi_retard_->setText(QString::number(replay_.late()));
   kpi_annule_->setText(QString::number(count_annule));
 }
 
@@ -302,6 +418,12 @@ void RealTimeWindow::construire_ui() {
   input_urgences_->setSuffix(" /h");
   form->addRow("Taux Urgences :", input_urgences_);
 
+  // Moteur en direct : pas de précalcul, salles / chirurgiens / lits
+  // modifiables pendant la lecture
+  mode_direct_ = new QCheckBox("Moteur en direct (sans précalcul)");
+  mode_direct_->setCursor(Qt::PointingHandCursor);
+  form->addRow(mode_direct_);
+
   config_layout->addLayout(form);
   left_layout->addWidget(config_card);
 
@@ -375,6 +497,13 @@ void RealTimeWindow::construire_ui() {
   barre_progression_->setStyleSheet(
       "QProgressBar::chunk { background-color: #2563eb; border-radius: 4px; }");
 
+  // Curseur de la chronologie : saut à n'importe quelle minute du scénario
+  curseur_temps_ = new QSlider(Qt::Horizontal, timeline_card);
+  curseur_temps_->setRange(0, static_cast<int>(fin_effective_minutes_));
+  curseur_temps_->setPageStep(60); // Une heure
+  curseur_temps_->setEnabled(false);
+  curseur_temps_->setToolTip("Faire glisser pour se déplacer dans la journée");
+
   label_temps_ = new QLabel("00:00", timeline_card);
   label_temps_->setAlignment(Qt::AlignCenter);
   label_temps_->setStyleSheet(
@@ -382,6 +511,7 @@ void RealTimeWindow::construire_ui() {
 
   timeline_layout->addWidget(lbl_progress);
   timeline_layout->addWidget(barre_progression_);
+  timeline_layout->addWidget(curseur_temps_);
   timeline_layout->addWidget(label_temps_);
 
   right_layout->addWidget(timeline_card); // On l'ajoute à la colonne de DROITE
@@ -413,30 +543,45 @@ void RealTimeWindow::construire_ui() {
   auto *lbl_table = new QLabel("État des Patients en Direct", table_container);
   lbl_table->setObjectName("blockLabel");
 
-  table_patients_ = new QTableWidget(table_container);
-  table_patients_->setColumnCount(5);
-  table_patients_->setHorizontalHeaderLabels(
-      {"ID", "Type", "Arrivée", "État Actuel", "Attente/Retard"});
+  // Filtre de la vue (sans copie : le proxy ne garde que des indices)
+  filtre_patients_ = new QComboBox(table_container);
+  filtre_patients_->addItems({"Tous les patients", "Urgences", "En attente"});
+
+  // Vue virtualisée : seules les lignes visibles sont calculées
+  modele_patients_ = new PatientTableModel(this);
+  proxy_patients_ = new PatientFilterModel(this);
+  proxy_patients_->setSourceModel(modele_patients_);
 
+  table_patients_ = new QTableView(table_container);
+  table_patients_->setModel(proxy_patients_);
   table_patients_->horizontalHeader()->setSectionResizeMode(
       QHeaderView::Stretch);
   table_patients_->verticalHeader()->setVisible(false);
   table_patients_->setAlternatingRowColors(true);
   table_patients_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  // Tri au clic sur l'en-tête ; par défaut, ordre d'arrivée du scénario
+  table_patients_->horizontalHeader()->setSortIndicator(-1,
+                                                        Qt::AscendingOrder);
+  table_patients_->setSortingEnabled(true);
 
   // Votre style CSS pour le tableau
   table_patients_->setStyleSheet(
-      "QTableWidget { background-color: #ffffff; alternate-background-color: "
+      "QTableView { background-color: #ffffff; alternate-background-color: "
       "#f8fafc; color: #1e293b; gridline-color: #e2e8f0; border: 1px solid "
       "#cbd5e1; border-radius: 8px; }"
-      "QTableWidget::item { padding: 5px; border-bottom: 1px solid #f1f5f9; }"
-      "QTableWidget::item:selected { background-color: #e0f2fe; color: "
+      "QTableView::item { padding: 5px; border-bottom: 1px solid #f1f5f9; }"
+      "QTableView::item:selected { background-color: #e0f2fe; color: "
       "#0c4a6e; }"
       "QHeaderView::section { background-color: #f1f5f9; padding: 6px; border: "
       "none; border-bottom: 2px solid #cbd5e1; font-weight: bold; color: "
       "#475569; }");
 
-  table_layout->addWidget(lbl_table);
+  auto *table_header = new QHBoxLayout();
+  table_header->addWidget(lbl_table);
+  table_header->addStretch();
+  table_header->addWidget(filtre_patients_);
+
+  table_layout->addLayout(table_header);
   table_layout->addWidget(table_patients_);
 
   central_splitter->addWidget(console_container);
@@ -500,81 +645,41 @@ void RealTimeWindow::construire_ui() {
           &RealTimeWindow::arreter_simulation);
   connect(btn_export_, &QPushButton::clicked, this,
           &RealTimeWindow::exporter_logs);
+  connect(curseur_temps_, &QSlider::valueChanged, this,
+          &RealTimeWindow::aller_a);
+
+  // Moteur en direct : salles, chirurgiens et lits changent en cours de
+  // journée
+  for (QSpinBox *input : {input_salles_, input_chirurgiens_, input_lits_})
+    connect(input, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &RealTimeWindow::changer_capacite);
+
+  // Paramètres modifiés pendant le calcul : le scénario en cours est
+  // abandonné
+  auto annuler_calcul = [this]() {
+    if (!calcul_->en_cours())
+      return;
+    arreter_simulation();
+    log_console_->appendPlainText(
+        ">>> Calcul annulé : paramètres modifiés.");
+  };
+  for (QSpinBox *input :
+       {input_salles_, input_chirurgiens_, input_lits_, input_patients_})
+    connect(input, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            annuler_calcul);
+  for (QDoubleSpinBox *input : {input_horizon_, input_urgences_})
+    connect(input, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            this, annuler_calcul);
+  connect(filtre_patients_,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          [this](int index) {
+            proxy_patients_->definir_filtre(
+                static_cast<PatientFilterModel::Filtre>(index));
+          });
 }
 
 void RealTimeWindow::mettre_a_jour_tableau_patients() {
-  for (size_t i = 0; i < patients_snapshots_.size(); ++i) {
-    const auto &p = patients_snapshots_[i];
-
-    QTableWidgetItem *itemState = table_patients_->item(i, 3);
-    QTableWidgetItem *itemDelay = table_patients_->item(i, 4);
-
-    // --- LOGIQUE D'ÉTAT ---
-    // 1. Le patient n'est pas encore là
-    if (temps_actuel_minutes_ < p.arrival_time) {
-      itemState->setText("Pas arrivé");
-      itemState->setForeground(QBrush(QColor("#94a3b8"))); // Gris
-      itemDelay->setText("-");
-    }
-    // 2. Le patient attend (Arrivé mais Chirurgie pas commencée)
-    else if (p.start_surgery_time < 0 ||
-             temps_actuel_minutes_ < p.start_surgery_time) {
-
-      // A. CAS ANNULÉ : Il n'a jamais été opéré (start < 0) ET on a dépassé
-      // l'heure limite
-      if (p.start_surgery_time < 0 &&
-          temps_actuel_minutes_ >= horizon_minutes_) {
-        itemState->setText("🚫 ANNULÉ");
-        itemState->setForeground(QBrush(QColor("#64748b"))); // Gris Ardoise
-        itemState->setFont(QFont("Segoe UI", 9, QFont::Bold));
-      }
-      // B. CAS ATTENTE : On est encore dans les horaires ou il va être opéré
-      // bientôt
-      else {
-        itemState->setText("EN ATTENTE BLOC");
-        itemState->setForeground(QBrush(QColor("#f97316"))); // Orange
-        itemState->setFont(QFont("Segoe UI", 9, QFont::Bold));
-      }
-
-      // Calcul de l'attente (valable dans les deux cas)
-      double attente = temps_actuel_minutes_ - p.arrival_time;
-      itemDelay->setText(QString::number(attente, 'f', 0) + " min");
-    }
-    // 3. Le patient est au bloc (Entre début et fin chir)
-    else if (temps_actuel_minutes_ >= p.start_surgery_time &&
-             temps_actuel_minutes_ < p.end_surgery_time) {
-      itemState->setText("🔴 AU BLOC OP");
-      itemState->setForeground(QBrush(QColor("#2563eb"))); // Bleu vif
-      itemState->setFont(QFont("Segoe UI", 9, QFont::Bold));
-
-      // On fige l'attente finale
-      double attente_finale = p.start_surgery_time - p.arrival_time;
-      itemDelay->setText(QString::number(attente_finale, 'f', 0) + " min");
-    }
-    // 4a. Attente Lit Réveil (La chirurgie est finie, mais le réveil n'a pas
-    // commencé)
-    else if (temps_actuel_minutes_ >= p.end_surgery_time &&
-             (p.start_recovery_time < 0 ||
-              temps_actuel_minutes_ < p.start_recovery_time)) {
-      itemState->setText("⏳ ATTENTE LIT");
-      itemState->setForeground(QBrush(QColor("#d97706"))); // Ambre
-      itemState->setFont(QFont("Segoe UI", 9, QFont::Bold));
-    }
-    // 4b. En Réveil (Vraiment dans le lit)
-    else if (p.start_recovery_time >= 0 &&
-             temps_actuel_minutes_ >= p.start_recovery_time &&
-             temps_actuel_minutes_ < p.end_recovery_time) {
-      itemState->setText("🔵 EN RÉVEIL");
-      itemState->setForeground(QBrush(QColor("#8b5cf6")));
-      itemState->setFont(QFont("Segoe UI", 9, QFont::Bold));
-    }
-    // 5. Le patient est sorti
-    else {
-      itemState->setText("✅ SORTI");
-      itemState->setForeground(QBrush(QColor("#10b981"))); // Vert
-      itemState->setFont(QFont("Segoe UI", 9, QFont::Normal));
-    }
-  }
+  modele_patients_->notifier_rejeu(temps_actuel_minutes_);
 }
 
 // --- LOGIQUE DE SIMULATION ---
@@ -582,8 +687,7 @@ void RealTimeWindow::mettre_a_jour_tableau_patients() {
 void RealTimeWindow::demarrer_simulation() {
   // Cas 1 : Démarrage initial OU Redémarrage après fin
   // Si le temps actuel a atteint la fin, on considère que c'est un redémarrage
-  if (temps_actuel_minutes_ == 0.0 ||
-      temps_actuel_minutes_ >= fin_effective_minutes_) {
+  if (!scenario_pret_ || temps_actuel_minutes_ >= fin_effective_minutes_) {
 
     // Si c'est un redémarrage (Recommencer), on nettoie d'abord l'UI
     if (temps_actuel_minutes_ >= fin_effective_minutes_) {
@@ -600,11 +704,20 @@ void RealTimeWindow::demarrer_simulation() {
     }
 
     log_console_->clear();
-    precalculer_scenario(); // On génère un nouveau jour
+    if (mode_direct_->isChecked()) {
+      demarrer_direct(); // Le moteur avance avec l'horloge
+    } else {
+      // On génère un nouveau jour : la lecture démarre quand il est prêt
+      precalculer_scenario();
+      return;
+    }
   }
 
   // Cas 2 : Reprise après pause (le timer repart simplement)
+  lancer_lecture();
+}
 
+void RealTimeWindow::lancer_lecture() {
   en_cours_ = true;
   timer_->start(50); // Vitesse : 50ms réel = 1 min simulée
 
@@ -626,12 +739,21 @@ void RealTimeWindow::mettre_en_pause() {
 }
 
 void RealTimeWindow::arreter_simulation() {
+  calcul_->annuler();
+  direct_.reset();
+  journal_direct_.reset();
   en_cours_ = false;
   timer_->stop();
   temps_actuel_minutes_ = 0;
+  scenario_pret_ = false;
 
   // Reset UI
   barre_progression_->setValue(0);
+  {
+    const QSignalBlocker bloqueur(curseur_temps_);
+    curseur_temps_->setValue(0);
+  }
+  curseur_temps_->setEnabled(false);
   // --- AJOUT ---
   // On remet le style bleu par défaut
   barre_progression_->setStyleSheet(
@@ -654,20 +776,28 @@ void RealTimeWindow::terminer_simulation() {
   en_cours_ = false;
   timer_->stop();
 
-  mettre_a_jour_tableau_patients();
+  if (!direct_) {
+    replay_.advance(temps_actuel_minutes_);
+    mettre_a_jour_tableau_patients();
+  }
   mettre_a_jour_kpi();
 
   // 2. On remplit la barre à 100% visuellement
   barre_progression_->setValue(barre_progression_->maximum());
+  {
+    const QSignalBlocker bloqueur(curseur_temps_);
+    curseur_temps_->setValue(static_cast<int>(temps_actuel_minutes_));
+  }
 
   // On vide les derniers logs restants (si un événement arrive pile à la
   // dernière minute)
   while (current_event_index_ < events_queue_.size()) {
     const auto &ev = events_queue_[current_event_index_];
     if (ev.time <= temps_actuel_minutes_) {
-      QString msg = QString("[t=%1 min] %2")
-                        .arg(ev.time, 0, 'f', 1)
-                        .arg(QString::fromStdString(ev.message));
+      QString msg =
+          QString("[t=%1 min] %2")
+              .arg(ev.time, 0, 'f', 1)
+              .arg(QString::fromStdString(format_trace_message(ev)));
       log_console_->appendPlainText(msg);
       current_event_index_++;
     } else {
@@ -714,19 +844,23 @@ void RealTimeWindow::exporter_logs() {
   // 2. En-tête du CSV
   out << "Temps (min);Evenement\n";
 
-  // 3. On parcourt notre liste d'évènements en mémoire
-  for (const auto &ev : events_queue_) {
-    // On n'exporte que les évènements qui se sont DÉJÀ produits
-    // (au cas où on exporte pendant une pause)
-    if (ev.time <= temps_actuel_minutes_) {
-
-      // On nettoie le message : si le message contient un ";", on le remplace
-      // par "," pour ne pas casser la colonne du CSV
-      QString message_propre =
-          QString::fromStdString(ev.message).replace(";", ",");
-
-      // Format : 12.5;Le patient arrive...
-      out << QString::number(ev.time, 'f', 1) << ";" << message_propre << "\n";
+  if (direct_) {
+    // 3a. Moteur en direct : recopie du journal écrit au fil des tics (il ne
+    // contient que des évènements déjà produits). Après la lecture, la
+    // position est en fin de fichier : les tics suivants y ajoutent la suite.
+    if (journal_direct_) {
+      journal_direct_->flush();
+      journal_direct_->seek(0);
+      while (!journal_direct_->atEnd())
+        out << QString::fromUtf8(journal_direct_->readLine());
+    }
+  } else {
+    // 3b. Rejeu : on parcourt notre liste d'évènements en mémoire
+    for (const auto &ev : events_queue_) {
+      // On n'exporte que les évènements qui se sont DÉJÀ produits
+      // (au cas où on exporte pendant une pause)
+      if (ev.time <= temps_actuel_minutes_)
+        out << ligne_csv(ev);
     }
   }
 
@@ -743,24 +877,36 @@ void RealTimeWindow::afficher_rapport_fin() {
   int retards = 0;
   double temps_attente_total = 0.0;
 
-  for (const auto &p : patients_snapshots_) {
-    // On ne compte que les patients qui devaient arriver avant la fin
-    if (p.arrival_time > horizon_minutes_)
-      continue;
-
-    if (p.type == PatientType::Urgent)
-      total_urgences++;
-    else
-      total_programmes++;
-
-    if (p.start_surgery_time >= 0) {
-      operes++;
-      double attente = p.start_surgery_time - p.arrival_time;
-      temps_attente_total += attente;
-      if (attente > 15.0)
-        retards++;
-    } else {
-      annules++;
+  if (direct_) {
+    // Moteur en direct : les patients sortis ne sont plus en mémoire, le
+    // bilan vient des indicateurs du moteur
+    const SimulationReport bilan = direct_->report();
+    total_programmes = bilan.elective_arrived;
+    total_urgences = bilan.urgent_arrived;
+    operes = bilan.patients_operated;
+    annules = bilan.operations_cancelled;
+    retards = bilan.operations_delayed;
+    temps_attente_total = bilan.average_wait_to_surgery * operes;
+  } else {
+    for (const auto &p : patients_snapshots_) {
+      // On ne compte que les patients qui devaient arriver avant la fin
+      if (p.arrival_time > horizon_minutes_)
+        continue;
+
+      if (p.type == PatientType::Urgent)
+        total_urgences++;
+      else
+        total_programmes++;
+
+      if (p.start_surgery_time >= 0) {
+        operes++;
+        double attente = p.start_surgery_time - p.arrival_time;
+        temps_attente_total += attente;
+        if (attente > 15.0)
+          retards++;
+      } else {
+        annules++;
+      }
     }
   }
 
@@ -944,11 +1090,7 @@ void RealTimeWindow::afficher_rapport_fin() {
   rapport.exec();
 }
 
-void RealTimeWindow::tic_horloge() {
-  // 1. On avance le temps
-  temps_actuel_minutes_ += 1.0;
-
-  // 3. Mise à jour Interface (Barre + Texte)
+void RealTimeWindow::afficher_horloge() {
   barre_progression_->setValue(static_cast<int>(temps_actuel_minutes_));
   int heures = static_cast<int>(temps_actuel_minutes_ / 60);
   int minutes = static_cast<int>(temps_actuel_minutes_) % 60;
@@ -972,6 +1114,74 @@ void RealTimeWindow::tic_horloge() {
     label_temps_->setStyleSheet(
         "font-size: 24pt; font-weight: bold; color: #1e293b;");
   }
+}
+
+void RealTimeWindow::reconstruire_console() {
+  // Position du journal : premier évènement après l'instant courant
+  const auto suivant = std::upper_bound(
+      events_queue_.begin(), events_queue_.end(), temps_actuel_minutes_,
+      [](double t, const TraceRecord &ev) { return t < ev.time; });
+  current_event_index_ = static_cast<size_t>(suivant - events_queue_.begin());
+
+  // Seules les dernières lignes sont réaffichées : le coût ne dépend pas du
+  // temps déjà écoulé
+  const size_t debut = current_event_index_ > kLignesConsole
+                           ? current_event_index_ - kLignesConsole
+                           : 0;
+  QStringList lignes;
+  lignes.reserve(static_cast<int>(current_event_index_ - debut));
+  for (size_t i = debut; i < current_event_index_; ++i) {
+    const auto &ev = events_queue_[i];
+    lignes << QString("[t=%1 min] %2")
+                  .arg(ev.time, 0, 'f', 1)
+                  .arg(QString::fromStdString(format_trace_message(ev)));
+  }
+  log_console_->setPlainText(lignes.join('\n'));
+  log_console_->moveCursor(QTextCursor::End);
+}
+
+void RealTimeWindow::aller_a(int minute) {
+  // Le moteur en direct ne revient pas en arrière
+  if (!scenario_pret_ || direct_)
+    return;
+  temps_actuel_minutes_ = minute;
+  afficher_horloge();
+
+  // Images clés et index des phases : ni rejeu depuis le début, ni parcours
+  // de tous les patients
+  replay_.seek(temps_actuel_minutes_);
+  mettre_a_jour_tableau_patients();
+  mettre_a_jour_kpi();
+  reconstruire_console();
+
+  // En pause (ou après la fin), la lecture reprend depuis la minute choisie
+  if (!en_cours_) {
+    btn_start_->setText(temps_actuel_minutes_ >= fin_effective_minutes_
+                            ? "Recommencer"
+                            : "Reprendre");
+    btn_start_->setEnabled(true);
+    btn_pause_->setEnabled(false);
+  }
+}
+
+void RealTimeWindow::tic_horloge() {
+  // 1. On avance le temps
+  temps_actuel_minutes_ += 1.0;
+
+  // 3. Mise à jour Interface (Barre + Texte + Curseur)
+  afficher_horloge();
+  {
+    const QSignalBlocker bloqueur(curseur_temps_);
+    curseur_temps_->setValue(static_cast<int>(temps_actuel_minutes_));
+  }
+
+  if (direct_) {
+    tic_direct();
+    return;
+  }
+
+  // Transitions franchies depuis le tic précédent
+  replay_.advance(temps_actuel_minutes_);
 
   // Mise à jour tableau patients
   mettre_a_jour_tableau_patients();
@@ -987,9 +1197,10 @@ void RealTimeWindow::tic_horloge() {
 
     if (ev.time <= temps_actuel_minutes_) {
       // C'est le moment d'afficher cet évènement !
-      QString message_formate = QString("[t=%1 min] %2")
-                                    .arg(ev.time, 0, 'f', 1)
-                                    .arg(QString::fromStdString(ev.message));
+      QString message_formate =
+          QString("[t=%1 min] %2")
+              .arg(ev.time, 0, 'f', 1)
+              .arg(QString::fromStdString(format_trace_message(ev)));
 
       log_console_->appendPlainText(message_formate);
 
@@ -1007,27 +1218,10 @@ void RealTimeWindow::tic_horloge() {
   // B. PLUS AUCUN patient n'est actif (ni au bloc, ni en réveil)
   // C. OU si on a atteint la fin absolue calculée par la simulation (sécurité)
 
-  bool activite_en_cours = false;
-
-  // On vérifie s'il reste des gens actifs via les snapshots
-  for (const auto &p : patients_snapshots_) {
-    // Est-il au bloc ou en réveil ou en nettoyage MAINTENANT ?
-    // On regarde si le temps actuel est compris dans ses intervalles d'activité
-    bool au_bloc = (p.start_surgery_time >= 0 &&
-                    temps_actuel_minutes_ < p.end_surgery_time);
-    bool en_reveil = (p.start_recovery_time >= 0 &&
-                      temps_actuel_minutes_ < p.end_recovery_time);
-
-    // Attention : il faut aussi compter le temps de nettoyage !
-    // (end_surgery_time + cleaning_time).
-    // Mais pour simplifier, si 'Au bloc' ou 'En réveil' est vrai, c'est
-    // suffisant.
-
-    if (au_bloc || en_reveil) {
-      activite_en_cours = true;
-      break; // Pas la peine de chercher plus loin, on continue !
-    }
-  }
+  // Fin de la dernière chirurgie ou du dernier réveil, calculée une fois
+  // au précalcul du scénario.
+  const bool activite_en_cours =
+      temps_actuel_minutes_ < replay_.activity_end();
 
   // Condition finale :
   // - Si on est avant l'horizon : on continue toujours.
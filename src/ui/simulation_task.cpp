@@ -0,0 +1,77 @@
+#include "ui/simulation_task.h"
+
+#include <QMetaObject>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <exception>
+
+SimulationTask::SimulationTask(QObject *parent) : QObject(parent) {}
+
+SimulationTask::~SimulationTask() {
+  annuler();
+  // Les calculs annulés rendent la main au prochain point de contrôle
+  for (QFuture<void> &calcul : calculs_)
+    calcul.waitForFinished();
+}
+
+void SimulationTask::annuler() {
+  if (courant_)
+    courant_->control.request_cancel();
+  courant_.reset();
+}
+
+void SimulationTask::lancer(Travail travail, Fin fin) {
+  annuler();
+  calculs_.erase(std::remove_if(calculs_.begin(), calculs_.end(),
+                                [](const QFuture<void> &calcul) {
+                                  return calcul.isFinished();
+                                }),
+                 calculs_.end());
+
+  auto execution = std::make_shared<Execution>();
+  courant_ = execution;
+
+  // Rappel sur le thread du calcul : relayé au thread GUI (au plus un
+  // message par palier de progression). Référence faible : l'exécution
+  // possède son rappel.
+  const std::weak_ptr<Execution> faible = execution;
+  execution->control.on_progress = [this, faible](double minutes,
+                                                  double horizon) {
+    QMetaObject::invokeMethod(
+        this,
+        [this, faible, minutes, horizon]() {
+          const std::shared_ptr<Execution> execution = faible.lock();
+          if (execution && courant_ == execution)
+            emit progression(minutes, horizon);
+        },
+        Qt::QueuedConnection);
+  };
+
+  calculs_.push_back(QtConcurrent::run(
+      [this, execution, travail = std::move(travail),
+       fin = std::move(fin)]() {
+        QString erreur;
+        try {
+          travail(execution->control);
+        } catch (const SimulationCancelled &) {
+          return;
+        } catch (const std::exception &ex) {
+          erreur = QString::fromUtf8(ex.what());
+        }
+        // Résultats remis au thread GUI ; ignorés si le calcul a été
+        // annulé entre-temps
+        QMetaObject::invokeMethod(
+            this,
+            [this, execution, erreur, fin]() {
+              if (courant_ != execution)
+                return;
+              courant_.reset();
+              if (erreur.isEmpty())
+                fin();
+              else
+                emit echec(erreur);
+            },
+            Qt::QueuedConnection);
+      }));
+}
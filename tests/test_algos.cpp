@@ -1,3 +1,4 @@
+#include "core/scenario.h"
 #include "core/simulation.h"
 #include <algorithm>
 #include <cmath>
@@ -34,8 +35,7 @@ std::string draw_bar(double value, double max_value, int width = 20) {
   return bar;
 }
 
-AlgoResult tester_politique(SchedulingPolicy policy,
-                            const std::string &nom_policy) {
+SimulationConfig config_saturation() {
   // 1. Configuration "Stress Test" (Goulot d'étranglement)
   SimulationConfig config;
   config.horizon_hours = 8.0;
@@ -49,12 +49,21 @@ AlgoResult tester_politique(SchedulingPolicy policy,
   config.mean_recovery_minutes = 40.0;
   config.cleaning_time_minutes = 10.0;
 
-  config.seed = 42; // Toujours la même graine pour comparer
-  config.policy = policy;
+  config.seed = 42;
   config.trace_events = false;
+  return config;
+}
+
+// Toutes les politiques jouent le même scénario (nombres aléatoires communs)
+AlgoResult tester_politique(SchedulingPolicy policy,
+                            const std::string &nom_policy,
+                            std::shared_ptr<const Scenario> scenario) {
+  SimulationConfig config = config_saturation();
+  config.policy = policy;
 
   // 2. Exécution
   Simulation sim(config);
+  sim.set_scenario(std::move(scenario));
   SimulationReport report = sim.run();
   const auto &patients = sim.get_patients();
 
@@ -162,11 +171,17 @@ int main() {
   try {
     std::vector<AlgoResult> resultats;
 
-    resultats.push_back(tester_politique(SchedulingPolicy::Fifo, "FIFO"));
+    // Le scénario (arrivées + durées) est tiré une seule fois
+    const SimulationConfig config = config_saturation();
+    const auto scenario =
+        Scenario::generate(config, RandomStreams::from_seed(config.seed));
+
     resultats.push_back(
-        tester_politique(SchedulingPolicy::PriorityFirst, "PRIORITÉ"));
+        tester_politique(SchedulingPolicy::Fifo, "FIFO", scenario));
+    resultats.push_back(tester_politique(SchedulingPolicy::PriorityFirst,
+                                         "PRIORITÉ", scenario));
     resultats.push_back(
-        tester_politique(SchedulingPolicy::Balanced, "ÉQUILIBRÉ"));
+        tester_politique(SchedulingPolicy::Balanced, "ÉQUILIBRÉ", scenario));
 
     afficher_tableau_et_graphique(resultats);
   } catch (const std::exception &e) {
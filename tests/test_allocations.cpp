@@ -0,0 +1,211 @@
+#include "core/alloc_tracking.h"
+#include "core/replication.h"
+#include "core/scenario.h"
+#include "core/simulation.h"
+#include "core/sweep.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// --- COMPTAGE DES ALLOCATIONS ---
+// Le test lie appmed_alloc_hooks : operator new global remplace, chaque
+// allocation du thread est comptee dans les portees AllocationScope actives.
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+SimulationConfig config_journee() {
+  SimulationConfig config;
+  config.horizon_hours = 24.0;
+  config.operating_rooms = 3;
+  config.surgeon_count = 3;
+  config.recovery_beds = 4;
+  config.elective_patients = 20;
+  config.elective_window_hours = 12.0;
+  config.urgent_rate_per_hour = 2.0;
+  return config;
+}
+
+// Allocations cumulees sur `runs` replications apres une replication de
+// chauffe (qui, elle, dimensionne les tampons).
+std::uint64_t allocations_regime_etabli(SimulationConfig config, int runs) {
+  config.seed = 1u;
+  Simulation sim(config);
+  sim.run();
+  AllocationScope portee;
+  for (int i = 0; i < runs; ++i) {
+    sim.reset(config, static_cast<unsigned int>(100 + i));
+    sim.run();
+  }
+  return portee.stats().allocations;
+}
+
+// Tas (backends par defaut) : aucune allocation. File calendrier : les seaux
+// ne sont jamais liberes, mais un seau grandit encore quand un run y range
+// plus d'evenements que tous les precedents ; on exige alors moins d'une
+// allocation par run (une reconstruction en couterait des dizaines).
+void verifier_regime_etabli(std::uint64_t allocations, int runs) {
+#if defined(APPMED_EVENT_QUEUE_CALENDAR)
+  assert_test(allocations < static_cast<std::uint64_t>(runs),
+              "Moins d'une allocation par run (file calendrier)");
+#else
+  (void)runs;
+  assert_test(allocations == 0, "Aucune allocation en regime etabli");
+#endif
+}
+
+// --- SCÉNARIO 1 : REPLICATIONS BATCH ---
+void test_reset_batch() {
+  print_header("Reset sans allocation (mode batch)");
+  const std::uint64_t allocations =
+      allocations_regime_etabli(config_journee(), 200);
+  std::cout << " -> Allocations sur 200 runs : " << allocations << "\n";
+  verifier_regime_etabli(allocations, 200);
+}
+
+// --- SCÉNARIO 2 : MODE FLUX ---
+void test_reset_flux() {
+  print_header("Reset sans allocation (mode flux)");
+  SimulationConfig config = config_journee();
+  config.streaming = true;
+  const std::uint64_t allocations = allocations_regime_etabli(config, 200);
+  std::cout << " -> Allocations sur 200 runs : " << allocations << "\n";
+  verifier_regime_etabli(allocations, 200);
+}
+
+// --- SCÉNARIO 3 : SCÉNARIO PARTAGÉ (CRN) ---
+void test_reset_scenario() {
+  print_header("Reset sans allocation (scenario partage)");
+  const SimulationConfig config = config_journee();
+  auto scenario = Scenario::generate(config, RandomStreams::from_seed(5u));
+  Simulation sim(config);
+  sim.set_scenario(scenario);
+  sim.run();
+
+  AllocationScope portee;
+  for (int i = 0; i < 50; ++i) {
+    SimulationConfig variante = config;
+    variante.policy = static_cast<SchedulingPolicy>(i % 3);
+    sim.reset(variante);
+    sim.run();
+  }
+  const std::uint64_t allocations = portee.stats().allocations;
+  std::cout << " -> Allocations sur 50 runs : " << allocations << "\n";
+  verifier_regime_etabli(allocations, 50);
+}
+
+// --- SCÉNARIO 4 : PORTÉES IMBRIQUÉES ---
+void test_portees_imbriquees() {
+  print_header("Comptage par portee (imbrication, pic)");
+  assert_test(allocation_tracking_available(), "Crochets operator new lies");
+
+  AllocationScope externe;
+  {
+    AllocationScope interne;
+    std::string *bloc = new std::string(1000, 'x');
+    delete bloc;
+    // Copie avant tout affichage (qui peut allouer).
+    const AllocationStats stats = interne.stats();
+    assert_test(stats.allocations >= 2,
+                "Allocations comptees dans la portee interne");
+    assert_test(stats.live_bytes == 0, "Memoire vive nulle apres liberation");
+    assert_test(stats.peak_live_bytes >= 1000,
+                "Pic de memoire vive >= taille du bloc");
+  }
+  assert_test(externe.stats().allocations >= 2,
+              "Allocations remontees dans la portee externe");
+}
+
+// --- SCÉNARIO 5 : STATISTIQUES PAR REPLICATION ---
+void test_allocations_par_replication() {
+  print_header("Allocations par replication (ReplicationRunner)");
+  ReplicationRunner runner(config_journee(), 1);
+  runner.run(5);
+  const auto &allocations = runner.allocations();
+  assert_test(allocations.size() == 5, "Une mesure par replication");
+  std::cout << " -> Replication 0 : " << allocations[0].allocations
+            << " allocations, pic " << allocations[0].peak_live_bytes
+            << " octets\n";
+  assert_test(allocations[0].allocations > 0 &&
+                  allocations[0].peak_live_bytes > 0,
+              "Premier run (dimensionnement) mesure");
+  for (const AllocationStats &stats : allocations) {
+    assert_test(stats.peak_live_bytes >= stats.live_bytes,
+                "Pic >= memoire vive finale");
+  }
+}
+
+// --- SCÉNARIO 6 : BUDGET MÉMOIRE ---
+void test_budget_memoire() {
+  print_header("Budget memoire depasse (arret propre)");
+  SimulationConfig config = config_journee();
+  config.elective_patients = 2000;
+
+  ReplicationRunner runner(config, 2);
+  runner.set_memory_budget(4096);
+  bool leve = false;
+  try {
+    runner.run(4);
+  } catch (const MemoryBudgetExceeded &ex) {
+    leve = true;
+    std::cout << " -> " << ex.what() << "\n";
+    assert_test(ex.budget() == 4096, "Diagnostic : budget rapporte");
+    assert_test(ex.live_bytes() + static_cast<std::int64_t>(ex.requested()) >
+                    4096,
+                "Diagnostic : depassement coherent");
+  }
+  assert_test(leve, "ReplicationRunner leve MemoryBudgetExceeded");
+
+  runner.set_memory_budget(0);
+  const ReplicationSummary summary = runner.run(4);
+  assert_test(summary.replications() == 4, "Lot relance sans budget");
+
+  SweepDefinition definition;
+  definition.base = config;
+  definition.axes = {SweepAxis::parse("operating_rooms=2,3")};
+  definition.replications = 2;
+  definition.memory_budget = 4096;
+  struct Ignorer : SweepSink {
+    void write_point(const SweepPointResult &) override {}
+  } ignorer;
+  leve = false;
+  try {
+    SweepRunner(definition, 2).run(ignorer);
+  } catch (const MemoryBudgetExceeded &) {
+    leve = true;
+  }
+  assert_test(leve, "SweepRunner leve MemoryBudgetExceeded");
+}
+
+int main() {
+  try {
+    test_reset_batch();
+    test_reset_flux();
+    test_reset_scenario();
+    test_portees_imbriquees();
+    test_allocations_par_replication();
+    test_budget_memoire();
+
+    std::cout << "\n========================================\n";
+    std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+    std::cout << "========================================\n";
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "Erreur fatale : " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,149 @@
+#include "core/event_queue.h"
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Deroule un scenario "hold" (pop + push plus tard) et renvoie l'ordre de
+// sortie des identifiants. Tous les backends doivent produire le meme.
+template <typename Queue> std::vector<int> derouler_hold(unsigned seed) {
+  std::mt19937 rng(seed);
+  std::exponential_distribution<double> gap(1.0 / 30.0);
+  std::uniform_int_distribution<int> minutes(0, 600);
+
+  std::vector<Event> initial;
+  for (int i = 0; i < 500; ++i) {
+    // Temps entiers : beaucoup d'evenements simultanes a departager.
+    initial.push_back(
+        Event{static_cast<double>(minutes(rng)), EventType::Arrival, i});
+  }
+
+  Queue queue;
+  queue.assign(initial);
+  std::vector<int> ordre;
+  int next_id = 500;
+  while (!queue.empty()) {
+    const Event e = queue.top();
+    queue.pop();
+    ordre.push_back(e.patient_id);
+    if (next_id < 5000) {
+      queue.push(Event{e.time + std::round(gap(rng)), EventType::SurgeryEnd,
+                       next_id++});
+    }
+  }
+  return ordre;
+}
+
+template <typename Queue> bool fifo_sur_egalite() {
+  Queue queue;
+  for (int i = 0; i < 100; ++i)
+    queue.push(Event{42.0, EventType::Arrival, i});
+  for (int i = 0; i < 100; ++i) {
+    if (queue.top().patient_id != i)
+      return false;
+    queue.pop();
+  }
+  return queue.empty();
+}
+
+// Taille oscillant entre 15 et 33 evenements : autour des anciens seuils
+// de la file calendrier (reduction sous 16, croissance au-dela de 32 seaux).
+// `observer` est appele apres chaque operation.
+template <typename Queue, typename Observer>
+std::vector<int> derouler_oscillation(Queue &queue, Observer observer) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> delai(1.0, 90.0);
+  std::vector<int> ordre;
+  int next_id = 0;
+  double now = 0.0;
+  for (int cycle = 0; cycle < 200; ++cycle) {
+    while (queue.size() < 33) {
+      queue.push(Event{now + std::round(delai(rng)), EventType::Arrival,
+                       next_id++});
+      observer(queue);
+    }
+    while (queue.size() > 15) {
+      now = queue.top().time;
+      ordre.push_back(queue.top().patient_id);
+      queue.pop();
+      observer(queue);
+    }
+  }
+  while (!queue.empty()) {
+    ordre.push_back(queue.top().patient_id);
+    queue.pop();
+  }
+  return ordre;
+}
+
+void test_ordre_identique() {
+  print_header("Ordre de sortie identique pour chaque backend");
+
+  const auto reference = derouler_hold<BinaryHeapEventQueue>(7);
+  assert_test(reference.size() == 5000, "Tous les evenements sont servis");
+  assert_test(derouler_hold<QuaternaryHeapEventQueue>(7) == reference,
+              "Tas 4-aire == tas binaire");
+  assert_test(derouler_hold<CalendarEventQueue>(7) == reference,
+              "File calendrier == tas binaire");
+}
+
+void test_egalites_deterministes() {
+  print_header("Departage des evenements simultanes");
+
+  assert_test(fifo_sur_egalite<BinaryHeapEventQueue>(),
+              "Tas binaire : premier insere, premier servi");
+  assert_test(fifo_sur_egalite<QuaternaryHeapEventQueue>(),
+              "Tas 4-aire : premier insere, premier servi");
+  assert_test(fifo_sur_egalite<CalendarEventQueue>(),
+              "File calendrier : premier insere, premier servi");
+}
+
+void test_oscillation_calendrier() {
+  print_header("File calendrier : taille oscillant autour d'un seuil");
+
+  BinaryHeapEventQueue tas;
+  const auto reference = derouler_oscillation(tas, [](const auto &) {});
+
+  CalendarEventQueue calendrier;
+  std::size_t changements = 0;
+  std::size_t seaux = calendrier.bucket_count();
+  const auto ordre =
+      derouler_oscillation(calendrier, [&](const CalendarEventQueue &q) {
+        if (q.bucket_count() != seaux)
+          ++changements;
+        seaux = q.bucket_count();
+      });
+  std::cout << " -> " << changements << " redimensionnements\n";
+  assert_test(ordre == reference, "File calendrier == tas binaire");
+  assert_test(changements <= 2,
+              "Pas de reconstruction a chaque passage du seuil");
+}
+
+int main() {
+  test_ordre_identique();
+  test_egalites_deterministes();
+  test_oscillation_calendrier();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
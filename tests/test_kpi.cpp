@@ -1,8 +1,13 @@
+#include "core/perf_counters.h"
 #include "core/simulation.h"
+#include "core/trace.h"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <locale>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -137,11 +142,505 @@ void test_priorite_urgence() {
   }
 }
 
+// --- SCÉNARIO 4 : STOCKAGE EN COLONNES (Cohérence ligne / colonnes) ---
+void test_table_patients() {
+  print_header("Table des Patients (Colonnes)");
+
+  SimulationConfig config;
+  config.seed = 7;
+  config.urgent_rate_per_hour = 1.5;
+
+  Simulation sim(config);
+  SimulationReport report = sim.run();
+  const PatientTable &patients = sim.get_patients();
+
+  int operes = 0;
+  bool coherent = true;
+  for (size_t i = 0; i < patients.size(); ++i) {
+    const PatientRef p = patients[i];
+    const Patient copie = p;
+    coherent = coherent && &p.id == &patients.id[i] &&
+               &p.start_surgery_time == &patients.start_surgery_time[i] &&
+               copie.id == patients.id[i] &&
+               copie.start_surgery_time == patients.start_surgery_time[i];
+    if (p.start_surgery_time >= 0)
+      ++operes;
+  }
+  assert_test(coherent, "La vue ligne reference les colonnes sans copie");
+  assert_test(operes == report.patients_operated,
+              "Les accumulateurs en ligne comptent les patients operes");
+  const SimulationReport courant = sim.report();
+  assert_test(courant.patients_operated == report.patients_operated &&
+                  courant.average_wait_to_surgery ==
+                      report.average_wait_to_surgery,
+              "report() redonne les indicateurs sans repasse");
+
+  const PatientTable tries = patients.sorted_by_arrival();
+  bool ordonne = tries.size() == patients.size();
+  for (size_t i = 1; i < tries.size(); ++i)
+    ordonne = ordonne && tries.arrival_time[i - 1] <= tries.arrival_time[i];
+  assert_test(ordonne, "Le tri par arrivee conserve tous les patients");
+}
+
+// --- SCÉNARIO 5 : TRACES TYPÉES (Formatage différé) ---
+void test_traces_typees() {
+  print_header("Traces Typees (Puits et texte historique)");
+
+  SimulationConfig config;
+  config.seed = 11;
+  config.trace_events = true;
+
+  TraceBuffer trace;
+  Simulation sim(config);
+  sim.set_trace_sink(&trace);
+  SimulationReport report = sim.run();
+
+  std::vector<std::string> textes;
+  Simulation sim_texte(config);
+  sim_texte.set_log_sink([&textes](const std::string &msg, double) {
+    textes.push_back(msg);
+  });
+  sim_texte.run();
+
+  if (!kTraceEnabled) {
+    assert_test(trace.records.empty() && textes.empty(),
+                "Traces supprimees a la compilation");
+    return;
+  }
+
+  int arrivees = 0;
+  for (const TraceRecord &r : trace.records)
+    if (r.kind == TraceKind::Arrival)
+      ++arrivees;
+  assert_test(arrivees == report.patients_arrived,
+              "Un enregistrement par arrivee");
+
+  bool identiques = textes.size() == trace.records.size();
+  for (size_t i = 0; identiques && i < textes.size(); ++i)
+    identiques = textes[i] == format_trace_message(trace.records[i]);
+  assert_test(identiques, "Le texte formate a la lecture est inchange");
+  assert_test(!textes.empty() &&
+                  textes.front().rfind("Patient ", 0) == 0,
+              "Premier evenement : une arrivee");
+}
+
+// --- SCÉNARIO 6 : MODE FLUX (Mémoire bornée) ---
+void test_mode_flux() {
+  print_header("Mode Flux (Memoire bornee, horizon long)");
+
+  SimulationConfig config;
+  config.seed = 2024;
+  config.horizon_hours = 24.0 * 30.0; // un mois
+  config.operating_rooms = 4;
+  config.surgeon_count = 4;
+  config.recovery_beds = 6;
+  config.elective_patients = 300;
+  config.elective_window_hours = 24.0 * 28.0;
+  config.urgent_rate_per_hour = 2.0;
+
+  Simulation batch(config);
+  const SimulationReport attendu = batch.run();
+
+  config.streaming = true;
+  Simulation flux(config);
+  const SimulationReport obtenu = flux.run();
+
+  std::cout << " -> Patients : " << obtenu.patients_arrived
+            << " | Emplacements (flux) : " << flux.get_patients().size()
+            << " | Lignes (batch) : " << batch.get_patients().size() << "\n";
+
+  assert_test(obtenu.patients_arrived == attendu.patients_arrived &&
+                  obtenu.patients_operated == attendu.patients_operated &&
+                  obtenu.patients_completed == attendu.patients_completed &&
+                  obtenu.operations_delayed == attendu.operations_delayed,
+              "Memes compteurs qu'en mode batch");
+  assert_test(obtenu.average_wait_to_surgery ==
+                      attendu.average_wait_to_surgery &&
+                  obtenu.average_total_time_in_system ==
+                      attendu.average_total_time_in_system &&
+                  obtenu.operating_room_utilization ==
+                      attendu.operating_room_utilization,
+              "Memes indicateurs (bit a bit) qu'en mode batch");
+  assert_test(flux.get_patients().size() * 10 < batch.get_patients().size(),
+              "La memoire suit les patients actifs, pas le total");
+
+  // Egalites de temps forcees (durees fixes) : departage par l'ordre
+  // d'arrivee d'origine, pas par les emplacements recycles
+  config.horizon_hours = 24.0 * 7.0;
+  config.elective_patients = 224; // une arrivee toutes les 45 min
+  config.elective_window_hours = 24.0 * 7.0;
+  bool identiques = true;
+  for (unsigned int seed : {2024u, 7u, 99u}) {
+    for (double cv : {0.25, 0.0}) {
+      for (SchedulingPolicy policy :
+           {SchedulingPolicy::Fifo, SchedulingPolicy::PriorityFirst,
+            SchedulingPolicy::Balanced}) {
+        SimulationConfig c = config;
+        c.seed = seed;
+        c.duration_cv = cv;
+        c.policy = policy;
+        c.trace_events = true;
+        TraceBuffer trace_batch, trace_flux;
+        c.streaming = false;
+        Simulation b(c);
+        b.set_trace_sink(&trace_batch);
+        const SimulationReport rb = b.run();
+        c.streaming = true;
+        Simulation f(c);
+        f.set_trace_sink(&trace_flux);
+        const SimulationReport rf = f.run();
+        bool meme_trace = trace_batch.records.size() ==
+                          trace_flux.records.size();
+        for (size_t i = 0; meme_trace && i < trace_flux.records.size();
+             ++i) {
+          const TraceRecord &x = trace_batch.records[i];
+          const TraceRecord &y = trace_flux.records[i];
+          meme_trace = x.time == y.time && x.kind == y.kind &&
+                       x.patient_id == y.patient_id;
+        }
+        const bool ok =
+            meme_trace && rf.patients_operated == rb.patients_operated &&
+            rf.average_wait_to_surgery == rb.average_wait_to_surgery &&
+            rf.average_wait_to_recovery == rb.average_wait_to_recovery &&
+            rf.max_wait_to_surgery == rb.max_wait_to_surgery &&
+            rf.operating_room_utilization == rb.operating_room_utilization &&
+            rf.recovery_bed_utilization == rb.recovery_bed_utilization;
+        if (!ok)
+          std::cout << " -> Ecart : graine " << seed << ", cv " << cv
+                    << ", " << scheduling_policy_to_string(policy) << "\n";
+        identiques = identiques && ok;
+      }
+    }
+  }
+  assert_test(identiques, "Meme trace evenement par evenement (3 graines, "
+                          "durees aleatoires et fixes, 3 politiques)");
+}
+
+// --- SCÉNARIO 7 : INSTANCES COMPILÉES (Politique x Trace) ---
+void test_instances_moteur() {
+  print_header("Instances du Moteur (Politique et Trace)");
+
+  const SchedulingPolicy politiques[] = {SchedulingPolicy::Fifo,
+                                         SchedulingPolicy::PriorityFirst,
+                                         SchedulingPolicy::Balanced};
+  for (SchedulingPolicy politique : politiques) {
+    SimulationConfig config;
+    config.seed = 31;
+    config.elective_patients = 16;
+    config.urgent_rate_per_hour = 2.5;
+    config.policy = politique;
+
+    Simulation sans_trace(config);
+    const SimulationReport a = sans_trace.run();
+
+    config.trace_events = true;
+    TraceBuffer trace;
+    Simulation avec_trace(config);
+    avec_trace.set_trace_sink(&trace);
+    const SimulationReport b = avec_trace.run();
+
+    assert_test(a.patients_operated == b.patients_operated &&
+                    a.average_wait_to_surgery == b.average_wait_to_surgery &&
+                    a.operations_delayed == b.operations_delayed,
+                "Politique " + scheduling_policy_to_string(politique) +
+                    " : trace sans effet sur les resultats");
+  }
+
+  // Les cles des types de politique reproduisent l'ordre historique
+  assert_test(PriorityFirstPolicy::rank(PatientType::Urgent, 500.0) <
+                  PriorityFirstPolicy::rank(PatientType::Elective, 0.0),
+              "PriorityFirst : l'urgence passe devant");
+  assert_test(BalancedPolicy::rank(PatientType::Urgent, 100.0) <
+                  BalancedPolicy::rank(PatientType::Elective, 50.0),
+              "Balanced : une urgence recente passe devant un programme");
+}
+
+// --- SCÉNARIO 8 : COMPTEURS DU MOTEUR ---
+void test_compteurs_moteur() {
+  print_header("Compteurs du Moteur (EngineStats)");
+  SimulationConfig config;
+  config.seed = 12;
+  config.operating_rooms = 1;
+  config.urgent_rate_per_hour = 3.0;
+  Simulation sim(config);
+  const SimulationReport sans = sim.run();
+  assert_test(sans.engine.total_events() == 0 && sans.engine.picks == 0,
+              "Desactives : aucun compteur collecte");
+
+  config.collect_stats = true;
+  sim.reset(config);
+  const SimulationReport r = sim.run();
+  const EngineStats &stats = r.engine;
+  const auto compte = [&](EventType type) {
+    return stats.events[static_cast<std::size_t>(type)];
+  };
+  assert_test(compte(EventType::Arrival) ==
+                      static_cast<std::uint64_t>(r.patients_arrived) &&
+                  compte(EventType::SurgeryEnd) ==
+                      static_cast<std::uint64_t>(r.patients_operated) &&
+                  compte(EventType::RecoveryEnd) ==
+                      static_cast<std::uint64_t>(r.patients_completed),
+              "Un evenement compte par arrivee, chirurgie et sortie");
+  assert_test(stats.picks == static_cast<std::uint64_t>(r.patients_operated) &&
+                  stats.handler_nanoseconds[0] > 0,
+              "Un choix de patient par operation, temps mesures");
+  // Une seule salle et des urgences frequentes : la file bloc s'allonge.
+  assert_test(stats.max_waiting_surgery > 1 &&
+                  stats.max_event_queue >= stats.max_waiting_surgery &&
+                  stats.mean_event_queue > 0.0 &&
+                  stats.mean_event_queue <= stats.max_event_queue,
+              "Profondeurs de files coherentes");
+  assert_test(r.patients_operated == sans.patients_operated &&
+                  r.average_wait_to_surgery == sans.average_wait_to_surgery,
+              "Compteurs sans effet sur les resultats");
+
+  // Cumul de deux runs (mode lot texte)
+  EngineStats cumul;
+  cumul.merge(stats);
+  cumul.merge(stats);
+  assert_test(cumul.total_events() == 2 * stats.total_events() &&
+                  cumul.picks == 2 * stats.picks &&
+                  cumul.max_event_queue == stats.max_event_queue &&
+                  std::abs(cumul.mean_event_queue - stats.mean_event_queue) <
+                      1e-9,
+              "Cumul : sommes, maxima et moyenne ponderee");
+}
+
+// --- SCÉNARIO 9 : TRACE CHROME / PERFETTO ---
+void test_trace_chrome() {
+  print_header("Export Chrome Trace (calcul + ressources)");
+  SimulationConfig config;
+  config.seed = 5;
+  config.operating_rooms = 2;
+  config.surgeon_count = 2;
+  config.recovery_beds = 2;
+  config.urgent_rate_per_hour = 3.0;
+  const SimulationReport reference = Simulation(config).run();
+
+  std::ostringstream json;
+  ChromeTraceWriter writer(json);
+  Simulation sim(config);
+  sim.set_profiler(&writer);
+  const SimulationReport r = sim.run();
+  const size_t salles = writer.lanes(ResourceKind::OperatingRoom);
+  const size_t lits = writer.lanes(ResourceKind::RecoveryBed);
+  writer.finish();
+  const std::string texte = json.str();
+
+  const auto compter = [&](const std::string &motif) {
+    size_t n = 0;
+    for (size_t pos = texte.find(motif); pos != std::string::npos;
+         pos = texte.find(motif, pos + 1))
+      ++n;
+    return n;
+  };
+  assert_test(texte.rfind("{\"traceEvents\":[", 0) == 0 &&
+                  texte.find("\"displayTimeUnit\"") != std::string::npos,
+              "Document Trace Event complet");
+  assert_test(compter("\"name\":\"run\"") == 1 &&
+                  compter("\"name\":\"seed_patients\"") == 1 &&
+                  compter("\"name\":\"arrival\"") ==
+                      static_cast<size_t>(r.patients_arrived) &&
+                  compter("\"name\":\"pick_next_patient\"") ==
+                      static_cast<size_t>(r.patients_operated),
+              "Spans : run, seed_patients, handlers et choix du patient");
+  // Pistes des salles : tid 1000 + i
+  assert_test(compter("\"tid\":1000,\"ts\"") +
+                      compter("\"tid\":1001,\"ts\"") ==
+                  static_cast<size_t>(r.patients_operated),
+              "Une occupation de salle par operation");
+  assert_test(salles <= static_cast<size_t>(config.operating_rooms) &&
+                  lits <= static_cast<size_t>(config.recovery_beds),
+              "Pas plus de pistes que de ressources");
+  assert_test(r.patients_operated == reference.patients_operated &&
+                  r.average_wait_to_surgery ==
+                      reference.average_wait_to_surgery,
+              "Profileur sans effet sur les resultats");
+  assert_test(r.engine.total_events() == 0,
+              "Sans collect_stats, report.engine reste vide");
+
+  // Flux de l'appelant intact ; mode flux : ids d'origine, pas emplacements
+  std::ostringstream flux_json;
+  flux_json << std::setprecision(9);
+  const auto drapeaux = flux_json.flags();
+  config.streaming = true;
+  config.horizon_hours = 48.0;
+  config.elective_patients = 60;
+  config.elective_window_hours = 40.0;
+  {
+    ChromeTraceWriter flux_writer(flux_json);
+    Simulation flux(config);
+    flux.set_profiler(&flux_writer);
+    const SimulationReport rf = flux.run();
+    flux_writer.finish();
+    std::vector<bool> vus(rf.patients_arrived, false);
+    bool distincts = true;
+    std::size_t salles_vues = 0;
+    const std::string flux_texte = flux_json.str();
+    const std::string motif = "\"tid\":100";
+    for (size_t pos = flux_texte.find(motif); pos != std::string::npos;
+         pos = flux_texte.find(motif, pos + 1)) {
+      // Occupations seulement (les metadonnees des pistes n'ont pas de ts)
+      if (flux_texte.compare(pos + motif.size() + 1, 6, ",\"ts\":") != 0)
+        continue;
+      const size_t args = flux_texte.find("\"patient\":", pos);
+      const int id = std::stoi(flux_texte.substr(args + 10));
+      distincts = distincts && id >= 0 && id < rf.patients_arrived &&
+                  !vus[static_cast<size_t>(id)];
+      if (distincts)
+        vus[static_cast<size_t>(id)] = true;
+      ++salles_vues;
+    }
+    // Des ids au-dela du nombre d'emplacements : pas d'emplacement recycle
+    const bool au_dela =
+        std::find(vus.begin() + static_cast<std::ptrdiff_t>(
+                                    flux.get_patients().size()),
+                  vus.end(), true) != vus.end();
+    assert_test(distincts && au_dela &&
+                    salles_vues == static_cast<size_t>(rf.patients_operated),
+                "Mode flux : une occupation de salle par id d'origine");
+  }
+  assert_test(flux_json.flags() == drapeaux && flux_json.precision() == 9 &&
+                  flux_json.getloc() == std::locale(),
+              "Etat du flux de l'appelant preserve");
+}
+
+// --- SCÉNARIO 10 : COMPTEURS MATÉRIELS PAR PHASE ---
+void test_compteurs_materiels() {
+  print_header("Compteurs Materiels par Phase (perf_event_open)");
+  SimulationConfig config;
+  config.seed = 9;
+  const SimulationReport reference = Simulation(config).run();
+
+  PerfProfiler perf;
+  assert_test(perf.available() || !perf.error().empty(),
+              "Indisponible => cause expliquee");
+  Simulation sim(config);
+  sim.set_profiler(&perf);
+  const SimulationReport r = sim.run();
+  bool phases = true;
+  for (size_t p = 0; p < kEnginePhases; ++p)
+    phases = phases && perf.phase(static_cast<EnginePhase>(p)).runs == 1;
+  assert_test(phases, "Seeding, boucle et rapport mesures une fois");
+  assert_test(r.engine.total_events() == 0,
+              "Boucle non instrumentee (aucun compteur moteur)");
+  assert_test(r.patients_operated == reference.patients_operated &&
+                  r.average_wait_to_surgery ==
+                      reference.average_wait_to_surgery,
+              "Profileur sans effet sur les resultats");
+  if (perf.counter_available(HardwareCounter::Instructions)) {
+    assert_test(perf.phase(EnginePhase::EventLoop).values[1] > 0,
+                "Instructions comptees dans la boucle");
+  } else {
+    std::cout << " [--] PMU indisponible : " << perf.error() << std::endl;
+  }
+}
+
+// --- SCÉNARIO 11 : OCCUPATION AU-DELA DE LA COUPURE (2,25 x HORIZON) ---
+double chevauchement(double debut, double fin, double limite) {
+  return std::max(0.0, std::min(fin, limite) - std::max(0.0, debut));
+}
+
+void test_occupation_coupure() {
+  print_header("Occupation : activites en cours a la coupure");
+
+  // Reveils tres longs : des lits sont encore occupes a 2,25 x horizon
+  SimulationConfig config;
+  config.seed = 31;
+  config.horizon_hours = 2.0;
+  config.operating_rooms = 4;
+  config.surgeon_count = 4;
+  config.recovery_beds = 40;
+  config.elective_patients = 6;
+  config.elective_window_hours = 1.5;
+  config.urgent_rate_per_hour = 1.0;
+  config.mean_recovery_minutes = 300.0;
+
+  Simulation sim(config);
+  const SimulationReport report = sim.run();
+  const PatientTable &p = sim.get_patients();
+
+  // Reference : durees completes de chaque activite commencee (calcul
+  // d'origine) ; le nettoyage ne commence qu'aux fins de chirurgie
+  // traitees avant la coupure.
+  const double horizon = config.horizon_hours * 60.0;
+  const double coupure = horizon * 2.25;
+  double salles = 0.0, chirurgiens = 0.0, lits = 0.0;
+  bool coupe = false;
+  for (size_t i = 0; i < p.size(); ++i) {
+    if (p.start_surgery_time[i] >= 0) {
+      salles += p.surgery_duration[i];
+      chirurgiens += p.surgery_duration[i];
+      if (p.end_surgery_time[i] <= coupure)
+        salles += config.cleaning_time_minutes;
+    }
+    if (p.start_recovery_time[i] >= 0) {
+      lits += p.recovery_duration[i];
+      coupe = coupe || p.end_recovery_time[i] > coupure;
+    }
+  }
+  // Reference relue dans la table : float32 avec APPMED_COMPACT_TIME
+  const double tolerance = sizeof(patient_time_t) < sizeof(double) ? 1e-5
+                                                                   : 1e-9;
+  const auto proche = [tolerance](double a, double b) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+  };
+  std::cout << " -> Lits : " << report.recovery_bed_utilization
+            << " (attendu " << lits / (horizon * config.recovery_beds)
+            << ")\n";
+  assert_test(coupe, "Des reveils depassent la coupure");
+  assert_test(report.recovery_bed_utilization < 1.0 &&
+                  report.operating_room_utilization < 1.0,
+              "Taux non plafonnes (comparaison significative)");
+  assert_test(
+      proche(report.operating_room_utilization,
+             salles / (horizon * config.operating_rooms)) &&
+          proche(report.surgeon_utilization,
+                 chirurgiens / (horizon * config.surgeon_count)) &&
+          proche(report.recovery_bed_utilization,
+                 lits / (horizon * config.recovery_beds)),
+      "Memes taux que les durees completes (calcul d'origine)");
+
+  // En cours de run : integrale jusqu'a l'horloge, rapportee au temps
+  // ecoule
+  Simulation direct(config);
+  direct.start();
+  direct.run_until(horizon * 0.75);
+  const double t = direct.state().clock;
+  const SimulationReport partiel = direct.report();
+  const PatientTable &q = direct.get_patients();
+  double salles_t = 0.0, lits_t = 0.0;
+  for (size_t i = 0; i < q.size(); ++i) {
+    if (q.start_surgery_time[i] >= 0)
+      salles_t += chevauchement(q.start_surgery_time[i],
+                                q.end_surgery_time[i] +
+                                    config.cleaning_time_minutes,
+                                t);
+    if (q.start_recovery_time[i] >= 0)
+      lits_t += chevauchement(q.start_recovery_time[i],
+                              q.end_recovery_time[i], t);
+  }
+  assert_test(t > 0.0 && !direct.finished(), "Run interrompu en cours");
+  assert_test(proche(partiel.operating_room_utilization,
+                     salles_t / (t * config.operating_rooms)) &&
+                  proche(partiel.recovery_bed_utilization,
+                         lits_t / (t * config.recovery_beds)),
+              "Rapport en cours : occupation sur le temps ecoule");
+}
+
 int main() {
   try {
     test_journee_ideale();
     test_saturation_realiste();
     test_priorite_urgence();
+    test_table_patients();
+    test_traces_typees();
+    test_mode_flux();
+    test_instances_moteur();
+    test_compteurs_moteur();
+    test_trace_chrome();
+    test_compteurs_materiels();
+    test_occupation_coupure();
 
     std::cout << "\n========================================\n";
     std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
@@ -0,0 +1,240 @@
+#include "core/simulation.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Journee chargee : files d'attente au bloc et au reveil.
+SimulationConfig config_chargee() {
+  SimulationConfig config;
+  config.seed = 99u;
+  config.horizon_hours = 24.0;
+  config.operating_rooms = 2;
+  config.surgeon_count = 2;
+  config.recovery_beds = 2;
+  config.elective_patients = 40;
+  config.elective_window_hours = 20.0;
+  config.urgent_rate_per_hour = 1.5;
+  return config;
+}
+
+bool rapports_identiques(const SimulationReport &a, const SimulationReport &b) {
+  return a.patients_arrived == b.patients_arrived &&
+         a.patients_operated == b.patients_operated &&
+         a.patients_completed == b.patients_completed &&
+         a.average_wait_to_surgery == b.average_wait_to_surgery &&
+         a.average_wait_to_recovery == b.average_wait_to_recovery &&
+         a.average_total_time_in_system == b.average_total_time_in_system &&
+         a.max_wait_to_surgery == b.max_wait_to_surgery &&
+         a.operating_room_utilization == b.operating_room_utilization &&
+         a.recovery_bed_utilization == b.recovery_bed_utilization &&
+         a.surgeon_utilization == b.surgeon_utilization &&
+         a.operations_delayed == b.operations_delayed &&
+         a.operations_cancelled == b.operations_cancelled;
+}
+
+bool traces_identiques(const std::vector<TraceRecord> &a,
+                       const std::vector<TraceRecord> &b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].time != b[i].time || a[i].kind != b[i].kind ||
+        a[i].patient_id != b[i].patient_id ||
+        a[i].busy_operating_rooms != b[i].busy_operating_rooms ||
+        a[i].busy_recovery_beds != b[i].busy_recovery_beds)
+      return false;
+  }
+  return true;
+}
+
+// --- SCÉNARIO 1 : RUN INCREMENTAL = RUN COMPLET ---
+void test_equivalence() {
+  print_header("run_until(t) minute par minute = run()");
+  for (SchedulingPolicy policy :
+       {SchedulingPolicy::Fifo, SchedulingPolicy::PriorityFirst,
+        SchedulingPolicy::Balanced}) {
+    for (bool streaming : {false, true}) {
+      SimulationConfig config = config_chargee();
+      config.policy = policy;
+      config.streaming = streaming;
+      config.trace_events = true;
+
+      Simulation reference(config);
+      TraceBuffer trace_reference;
+      reference.set_trace_sink(&trace_reference);
+      const SimulationReport attendu = reference.run();
+
+      Simulation direct(config);
+      TraceBuffer trace;
+      direct.set_trace_sink(&trace);
+      direct.start();
+      bool horloge_ok = true;
+      double t = 0.0;
+      while (!direct.finished()) {
+        t += 1.0;
+        direct.run_until(t);
+        horloge_ok = horloge_ok && direct.state().clock <= t;
+      }
+      const std::string nom = scheduling_policy_to_string(policy) +
+                              (streaming ? " (flux)" : "");
+      assert_test(rapports_identiques(direct.report(), attendu),
+                  "Rapport identique : " + nom);
+      assert_test(traces_identiques(trace.records, trace_reference.records),
+                  "Trace identique : " + nom);
+      assert_test(horloge_ok, "Aucun evenement au-dela de t : " + nom);
+    }
+  }
+}
+
+// --- SCÉNARIO 2 : PAS A PAS ET ÉTAT COURANT ---
+void test_pas_a_pas() {
+  print_header("step() et etat courant");
+  SimulationConfig config = config_chargee();
+  config.collect_stats = true;
+  Simulation reference(config);
+  const SimulationReport attendu = reference.run();
+
+  config.collect_stats = false;
+  config.streaming = true;
+  Simulation direct(config);
+  assert_test(!direct.step(), "step() sans start() ne fait rien");
+  direct.start();
+  std::uint64_t pas = 0;
+  bool capacites_ok = true;
+  std::size_t residents_max = 0;
+  while (direct.step()) {
+    ++pas;
+    const SimulationState etat = direct.state();
+    capacites_ok = capacites_ok &&
+                   etat.busy_operating_rooms <= config.operating_rooms &&
+                   etat.busy_surgeons <= config.surgeon_count &&
+                   etat.busy_recovery_beds <= config.recovery_beds;
+    residents_max = std::max(residents_max, etat.resident_patients);
+  }
+  std::cout << " -> " << pas << " evenements, " << residents_max
+            << " patients residents au plus sur " << attendu.patients_arrived
+            << "\n";
+  assert_test(pas == attendu.engine.total_events(),
+              "Un evenement par pas");
+  assert_test(capacites_ok, "Ressources occupees dans les capacites");
+  assert_test(residents_max < static_cast<size_t>(attendu.patients_arrived),
+              "Memoire bornee par les patients actifs (mode flux)");
+  assert_test(direct.finished() && !direct.step(), "Run termine");
+}
+
+// --- SCÉNARIO 3 : CAPACITÉS MODIFIÉES EN COURS DE RUN ---
+void test_capacites() {
+  print_header("Ouverture d'une salle et d'un lit en cours de run");
+  SimulationConfig config = config_chargee();
+  Simulation base(config);
+  const SimulationReport sans_changement = base.run();
+
+  // Changement a t = 0 : equivalent a la configuration elargie
+  SimulationConfig elargie = config;
+  elargie.operating_rooms = 3;
+  elargie.surgeon_count = 3;
+  Simulation reference(elargie);
+  const SimulationReport attendu = reference.run();
+
+  Simulation direct(config);
+  direct.start();
+  direct.set_capacity({3, 3, config.recovery_beds}, 0.0);
+  direct.run_until(1e9);
+  assert_test(rapports_identiques(direct.report(), attendu),
+              "Changement a t=0 = configuration elargie");
+
+  // A mi-journee : plus de patients operes, occupation toujours <= 100 %
+  const double midi = config.horizon_hours * 60.0 / 2.0;
+  direct.reset(config);
+  direct.start();
+  direct.run_until(midi);
+  const int attente_avant = static_cast<int>(direct.state().waiting_surgery);
+  direct.set_capacity({4, 4, 4}, midi);
+  const SimulationState apres = direct.state();
+  direct.run_until(1e9);
+  const SimulationReport rapport = direct.report();
+  std::cout << " -> " << attente_avant << " en attente a mi-journee, "
+            << rapport.patients_operated << " operes (contre "
+            << sans_changement.patients_operated << ")\n";
+  assert_test(attente_avant > 0 &&
+                  apres.busy_operating_rooms > config.operating_rooms,
+              "Patients en attente servis des l'ouverture");
+  assert_test(rapport.patients_operated > sans_changement.patients_operated,
+              "Plus de patients operes");
+  assert_test(rapport.operating_room_utilization <= 1.0 &&
+                  rapport.recovery_bed_utilization <= 1.0 &&
+                  rapport.surgeon_utilization <= 1.0,
+              "Occupation rapportee a la capacite integree");
+  assert_test(direct.capacity().operating_rooms == 4, "Capacite courante");
+}
+
+// --- SCÉNARIO 4 : CHANGEMENT AU-DELA DES EVENEMENTS EN ATTENTE ---
+void test_capacite_anticipee() {
+  print_header("set_capacity(at) apres des evenements en attente");
+  const SimulationConfig config = config_chargee();
+  const double midi = config.horizon_hours * 60.0 / 2.0;
+  const ResourceCapacity elargie{4, 4, 4};
+
+  // Reference : evenements jusqu'a midi traites explicitement
+  Simulation reference(config);
+  TraceBuffer trace_reference;
+  reference.set_trace_sink(&trace_reference);
+  reference.start();
+  reference.run_until(midi);
+  reference.set_capacity(elargie, midi);
+  reference.run_until(1e9);
+
+  // Changement annonce des le debut du run pour midi
+  Simulation direct(config);
+  TraceBuffer trace;
+  direct.set_trace_sink(&trace);
+  direct.start();
+  direct.run_until(60.0);
+  const std::size_t en_attente = direct.state().pending_events;
+  direct.set_capacity(elargie, midi);
+  const SimulationState apres = direct.state();
+  const SimulationReport en_cours = direct.report();
+  direct.run_until(1e9);
+
+  assert_test(en_attente > 0, "Evenements en attente avant at");
+  assert_test(apres.clock <= midi, "Horloge jamais au-dela de at");
+  assert_test(en_cours.operating_room_utilization >= 0.0 &&
+                  en_cours.operating_room_utilization <= 1.0 &&
+                  en_cours.recovery_bed_utilization >= 0.0 &&
+                  en_cours.surgeon_utilization >= 0.0,
+              "Occupation dans [0, 1] au moment du changement");
+  assert_test(rapports_identiques(direct.report(), reference.report()),
+              "Rapport identique a run_until(at) puis set_capacity");
+  assert_test(traces_identiques(trace.records, trace_reference.records),
+              "Trace identique a run_until(at) puis set_capacity");
+}
+
+int main() {
+  test_equivalence();
+  test_pas_a_pas();
+  test_capacites();
+  test_capacite_anticipee();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
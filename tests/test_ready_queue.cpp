@@ -0,0 +1,96 @@
+#include "core/ready_queue.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+std::vector<ReadyKey> generer_cles(int nombre, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> rang(0, 3);
+  std::uniform_real_distribution<double> arrivee(0.0, 2000.0);
+  std::vector<ReadyKey> cles;
+  for (int id = 0; id < nombre; ++id)
+    cles.push_back(ReadyKey{static_cast<double>(rang(rng)), arrivee(rng), id});
+  return cles;
+}
+
+// --- SCÉNARIO 1 : Ordre de service conforme a la cle ---
+void test_ordre_de_service() {
+  print_header("File d'attente indexee : ordre de service");
+
+  auto cles = generer_cles(100000, 3);
+  ReadyQueue file;
+  file.reserve(cles.size());
+  for (const ReadyKey &k : cles)
+    file.push(k);
+
+  std::sort(cles.begin(), cles.end(), ready_before);
+  bool ordre_ok = true;
+  for (const ReadyKey &attendu : cles) {
+    if (file.pop() != attendu.patient_id) {
+      ordre_ok = false;
+      break;
+    }
+  }
+  assert_test(ordre_ok, "100k patients servis dans l'ordre (rang, arrivee, id)");
+  assert_test(file.empty(), "La file est vide apres service complet");
+}
+
+// --- SCÉNARIO 2 : Retrait d'un patient quelconque ---
+void test_retrait_arbitraire() {
+  print_header("File d'attente indexee : retrait arbitraire");
+
+  auto cles = generer_cles(5000, 11);
+  ReadyQueue file;
+  for (const ReadyKey &k : cles)
+    file.push(k);
+
+  // On retire un patient sur trois (annulations)
+  for (int id = 0; id < 5000; id += 3)
+    file.erase(id);
+  assert_test(!file.contains(3) && file.contains(4),
+              "Les patients retires ne sont plus indexes");
+  assert_test(!file.erase(3), "Un second retrait est refuse");
+
+  cles.erase(std::remove_if(cles.begin(), cles.end(),
+                            [](const ReadyKey &k) {
+                              return k.patient_id % 3 == 0;
+                            }),
+             cles.end());
+  std::sort(cles.begin(), cles.end(), ready_before);
+  bool ordre_ok = file.size() == cles.size();
+  for (const ReadyKey &attendu : cles) {
+    if (!ordre_ok || file.pop() != attendu.patient_id)
+      ordre_ok = false;
+  }
+  assert_test(ordre_ok, "L'ordre reste correct apres les retraits");
+}
+
+int main() {
+  test_ordre_de_service();
+  test_retrait_arbitraire();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
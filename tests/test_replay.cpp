@@ -0,0 +1,250 @@
+#include "core/replay.h"
+#include "core/simulation.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Journee saturee : des patients attendent au-dela de l'horizon et ne sont
+// jamais operes.
+SimulationConfig config_saturee() {
+  SimulationConfig config;
+  config.seed = 77u;
+  config.horizon_hours = 8.0;
+  config.operating_rooms = 1;
+  config.surgeon_count = 1;
+  config.recovery_beds = 1;
+  config.elective_patients = 25;
+  config.elective_window_hours = 6.0;
+  config.urgent_rate_per_hour = 1.5;
+  return config;
+}
+
+// --- RÉFÉRENCE : RESCAN COMPLET (ancienne logique du rejeu) ---
+
+ReplayState etat_rescan(const PatientTable &p, size_t i, double t,
+                        double horizon) {
+  if (t < p.arrival_time[i])
+    return ReplayState::NotArrived;
+  if (p.start_surgery_time[i] < 0)
+    return t >= horizon ? ReplayState::Cancelled : ReplayState::Unscheduled;
+  if (t < p.start_surgery_time[i])
+    return ReplayState::Waiting;
+  if (t < p.end_surgery_time[i])
+    return ReplayState::InSurgery;
+  if (p.start_recovery_time[i] < 0 || t < p.start_recovery_time[i])
+    return ReplayState::AwaitingBed;
+  if (t < p.end_recovery_time[i])
+    return ReplayState::InRecovery;
+  return ReplayState::Discharged;
+}
+
+int retards_rescan(const PatientTable &p, double t) {
+  int retards = 0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    const double debut = p.start_surgery_time[i];
+    if (t < p.arrival_time[i] || debut < 0)
+      continue;
+    const double attente = t >= debut ? debut - p.arrival_time[i]
+                                      : t - p.arrival_time[i];
+    if (attente > 15.0)
+      ++retards;
+  }
+  return retards;
+}
+
+bool activite_rescan(const PatientTable &p, double t) {
+  for (size_t i = 0; i < p.size(); ++i) {
+    if ((p.start_surgery_time[i] >= 0 && t < p.end_surgery_time[i]) ||
+        (p.start_recovery_time[i] >= 0 && t < p.end_recovery_time[i]))
+      return true;
+  }
+  return false;
+}
+
+// --- SCÉNARIO 1 : DELTAS = RESCAN ---
+void test_deltas_equivalents() {
+  print_header("Rejeu par deltas identique au rescan complet");
+  const SimulationConfig config = config_saturee();
+  Simulation sim(config);
+  sim.run();
+  const PatientTable patients = sim.get_patients().sorted_by_arrival();
+  const double horizon = config.horizon_hours * 60.0;
+
+  ReplayCursor cursor(patients, horizon);
+  std::vector<ReplayState> affiche(patients.size(), ReplayState::NotArrived);
+  bool etats_ok = true, compteurs_ok = true, lignes_ok = true;
+  bool retards_ok = true, activite_ok = true;
+  int annules = 0;
+  for (double t = 1.0; t <= horizon + 600.0; t += 1.0) {
+    cursor.advance(t);
+    // La vue n'applique que les lignes signalees.
+    for (std::uint32_t row : cursor.changed_rows())
+      affiche[row] = cursor.state(row);
+
+    int comptes[kReplayStates] = {};
+    for (size_t i = 0; i < patients.size(); ++i) {
+      const ReplayState attendu = etat_rescan(patients, i, t, horizon);
+      ++comptes[static_cast<size_t>(attendu)];
+      etats_ok = etats_ok && cursor.state(i) == attendu;
+      lignes_ok = lignes_ok && affiche[i] == attendu;
+    }
+    for (size_t s = 0; s < kReplayStates; ++s) {
+      compteurs_ok = compteurs_ok &&
+                     cursor.count(static_cast<ReplayState>(s)) == comptes[s];
+    }
+    retards_ok = retards_ok && cursor.late() == retards_rescan(patients, t);
+    activite_ok = activite_ok && (t < cursor.activity_end()) ==
+                                     activite_rescan(patients, t);
+    annules = cursor.count(ReplayState::Cancelled);
+  }
+  std::cout << " -> " << patients.size() << " patients, "
+            << cursor.transitions().size() << " transitions, " << annules
+            << " annules\n";
+  assert_test(annules > 0, "Scenario avec annulations");
+  assert_test(etats_ok, "Etat par ligne identique a chaque pas");
+  assert_test(lignes_ok, "Lignes modifiees suffisantes pour la vue");
+  assert_test(compteurs_ok, "Compteurs par etat identiques");
+  assert_test(retards_ok, "Retards identiques");
+  assert_test(activite_ok, "Fin d'activite identique");
+  assert_test(cursor.finished(), "Toutes les transitions appliquees");
+}
+
+// --- SCÉNARIO 2 : SEULES LES LIGNES MODIFIÉES SONT SIGNALÉES ---
+void test_lignes_modifiees() {
+  print_header("Lignes signalees = lignes changees");
+  const SimulationConfig config = config_saturee();
+  Simulation sim(config);
+  sim.run();
+  const PatientTable patients = sim.get_patients().sorted_by_arrival();
+  ReplayCursor cursor(patients, config.horizon_hours * 60.0);
+
+  std::vector<ReplayState> avant(patients.size(), ReplayState::NotArrived);
+  bool exactes = true;
+  size_t signalees = 0, pas = 0;
+  for (double t = 1.0; !cursor.finished(); t += 1.0, ++pas) {
+    cursor.advance(t);
+    std::vector<bool> marque(patients.size(), false);
+    for (std::uint32_t row : cursor.changed_rows()) {
+      exactes = exactes && !marque[row];
+      marque[row] = true;
+    }
+    for (size_t i = 0; i < patients.size(); ++i) {
+      // Une ligne peut transiter et revenir au meme etat dans un pas : elle
+      // est alors signalee, jamais l'inverse.
+      exactes = exactes && (marque[i] || cursor.state(i) == avant[i]);
+      avant[i] = cursor.state(i);
+    }
+    signalees += cursor.changed_rows().size();
+  }
+  std::cout << " -> " << signalees << " lignes signalees sur " << pas
+            << " pas (" << pas * patients.size() << " en rescan)\n";
+  assert_test(exactes, "Aucune ligne oubliee ni doublon");
+  assert_test(signalees <= cursor.transitions().size(),
+              "Au plus une mise a jour par transition");
+
+  cursor.advance(1.0);
+  assert_test(cursor.changed_rows().empty(), "Retour en arriere ignore");
+}
+
+// --- SCÉNARIO 3 : SAUTS DANS LA CHRONOLOGIE ---
+void test_seek() {
+  print_header("Seek avant/arriere (images cles, index des phases)");
+  SimulationConfig config = config_saturee();
+  config.horizon_hours = 72.0;
+  config.operating_rooms = 4;
+  config.surgeon_count = 4;
+  config.recovery_beds = 5;
+  config.elective_patients = 200;
+  config.elective_window_hours = 60.0;
+  config.urgent_rate_per_hour = 2.0;
+  Simulation sim(config);
+  sim.run();
+  const PatientTable patients = sim.get_patients().sorted_by_arrival();
+  const double horizon = config.horizon_hours * 60.0;
+  ReplayCursor cursor(patients, horizon);
+  std::cout << " -> " << patients.size() << " patients, "
+            << cursor.transitions().size() << " transitions\n";
+  assert_test(cursor.transitions().size() >
+                  4 * ReplayCursor::kKeyframeInterval,
+              "Plusieurs images cles");
+
+  std::mt19937 rng(11u);
+  std::uniform_real_distribution<double> instant(0.0, horizon + 600.0);
+  std::vector<ReplayState> affiche(patients.size(), ReplayState::NotArrived);
+  bool etats_ok = true, lignes_ok = true, compteurs_ok = true;
+  bool retards_ok = true;
+  for (int essai = 0; essai < 200; ++essai) {
+    // Sauts aleatoires, entrecoupes de petits pas (lecture apres un seek)
+    const double t = essai % 4 == 3 ? cursor.time() + 1.0
+                                    : std::floor(instant(rng));
+    if (essai % 4 == 3)
+      cursor.advance(t);
+    else
+      cursor.seek(t);
+    for (std::uint32_t row : cursor.changed_rows())
+      affiche[row] = cursor.state(row);
+
+    int comptes[kReplayStates] = {};
+    for (size_t i = 0; i < patients.size(); ++i) {
+      const ReplayState attendu = etat_rescan(patients, i, t, horizon);
+      ++comptes[static_cast<size_t>(attendu)];
+      etats_ok = etats_ok && cursor.state(i) == attendu &&
+                 cursor.state_at(i, t) == attendu;
+      lignes_ok = lignes_ok && affiche[i] == attendu;
+    }
+    for (size_t s = 0; s < kReplayStates; ++s) {
+      compteurs_ok = compteurs_ok &&
+                     cursor.count(static_cast<ReplayState>(s)) == comptes[s];
+    }
+    retards_ok = retards_ok && cursor.late() == retards_rescan(patients, t);
+  }
+  assert_test(etats_ok, "Etat par ligne identique apres chaque saut");
+  assert_test(lignes_ok, "Lignes modifiees suffisantes pour la vue");
+  assert_test(compteurs_ok, "Compteurs reconstruits depuis les images cles");
+  assert_test(retards_ok, "Retards identiques");
+
+  size_t attente = 0;
+  for (size_t i = 0; i < patients.size(); ++i) {
+    const ReplayState etat = cursor.state(i);
+    attente += etat == ReplayState::Waiting ||
+               etat == ReplayState::Unscheduled ||
+               etat == ReplayState::Cancelled;
+  }
+  assert_test(cursor.waiting_rows().size() == attente,
+              "Lignes en attente reconstruites");
+
+  cursor.seek(0.0);
+  assert_test(cursor.count(ReplayState::NotArrived) ==
+                  static_cast<int>(patients.size()),
+              "Retour au debut");
+}
+
+int main() {
+  test_deltas_equivalents();
+  test_lignes_modifiees();
+  test_seek();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include "core/replication.h"
+#include "core/scenario.h"
+#include "core/variates.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+bool identiques(const ReplicationSummary &a, const ReplicationSummary &b) {
+  for (size_t i = 0; i < a.metrics.size(); ++i) {
+    const RunningStat &x = a.metrics[i];
+    const RunningStat &y = b.metrics[i];
+    if (x.count != y.count || x.mean != y.mean || x.m2 != y.m2 ||
+        x.min != y.min || x.max != y.max)
+      return false;
+  }
+  return true;
+}
+
+SimulationConfig config_charge() {
+  SimulationConfig config;
+  config.seed = 2024;
+  config.horizon_hours = 10.0;
+  config.operating_rooms = 3;
+  config.elective_patients = 18;
+  config.urgent_rate_per_hour = 2.5;
+  return config;
+}
+
+// --- SCÉNARIO 1 : Resultat independant du nombre de threads ---
+void test_determinisme_threads() {
+  print_header("Replications : independance au nombre de threads");
+
+  ReplicationRunner seul(config_charge(), 1);
+  const ReplicationSummary reference = seul.run(48);
+  assert_test(reference.replications() == 48, "48 replications agregees");
+
+  for (int threads : {2, 3, 8}) {
+    ReplicationRunner runner(config_charge(), threads);
+    assert_test(identiques(runner.run(48), reference),
+                "Agregat identique au bit pres avec " +
+                    std::to_string(threads) + " threads");
+  }
+
+  // Moins de replications que de threads : un moteur par replication
+  ReplicationRunner large(config_charge(), 8);
+  assert_test(identiques(large.run(3), seul.run(3)),
+              "3 replications sur 8 threads == 1 thread");
+}
+
+// --- SCÉNARIO 2 : Fusion associative des agregats ---
+void test_fusion() {
+  print_header("Replications : fusion des agregats");
+
+  ReplicationRunner runner(config_charge(), 4);
+  const ReplicationSummary total = runner.run(30);
+  const auto &rapports = runner.reports();
+
+  ReplicationSummary a, b, c;
+  for (int i = 0; i < 30; ++i)
+    (i < 10 ? a : (i < 20 ? b : c)).add(rapports[i]);
+
+  ReplicationSummary gauche = a; // (a + b) + c
+  gauche.merge(b);
+  gauche.merge(c);
+  ReplicationSummary droite = b; // a + (b + c)
+  droite.merge(c);
+  ReplicationSummary tmp = a;
+  tmp.merge(droite);
+
+  const RunningStat &w1 = gauche.metric("average_wait_to_surgery");
+  const RunningStat &w2 = tmp.metric("average_wait_to_surgery");
+  const RunningStat &wt = total.metric("average_wait_to_surgery");
+  assert_test(w1.count == 30 && w2.count == 30, "Les effectifs s'additionnent");
+  assert_test(std::abs(w1.mean - wt.mean) < 1e-9 &&
+                  std::abs(w2.mean - wt.mean) < 1e-9,
+              "Moyenne fusionnee == moyenne globale");
+  assert_test(std::abs(w1.variance() - wt.variance()) < 1e-6 &&
+                  std::abs(w2.variance() - wt.variance()) < 1e-6,
+              "Variance fusionnee == variance globale");
+
+  std::cout << " -> Attente moyenne bloc : " << wt.mean << " +/- "
+            << wt.ci95_half_width() << " min (IC 95%)\n";
+  assert_test(wt.ci95_half_width() > 0.0, "Intervalle de confiance non nul");
+}
+
+// --- SCÉNARIO 3 : Flux aleatoires reproductibles ---
+void test_flux_aleatoires() {
+  print_header("Flux xoshiro256++ : sauts et sous-flux");
+
+  Xoshiro256PlusPlus a(7), b(7);
+  bool meme_suite = true;
+  for (int i = 0; i < 1000; ++i)
+    meme_suite = meme_suite && (a() == b());
+  assert_test(meme_suite, "Meme graine, meme suite");
+
+  Xoshiro256PlusPlus saut(7);
+  saut.jump();
+  assert_test(saut != Xoshiro256PlusPlus(7), "jump() change l'etat");
+
+  ReplicationStreams flux(7);
+  const RandomStreams r0 = flux.next();
+  const RandomStreams r1 = flux.next();
+  assert_test(r0.urgent_arrivals == RandomStreams::from_seed(7).urgent_arrivals,
+              "La replication 0 correspond au run unique");
+  assert_test(r0.urgent_arrivals != r1.urgent_arrivals &&
+                  r0.urgent_arrivals != r0.elective_surgery &&
+                  r0.elective_surgery != r0.urgent_surgery,
+              "Replications et usages ont des flux distincts");
+
+  // Une replication isolee redonne le meme rapport que dans le lot.
+  ReplicationRunner runner(config_charge(), 3);
+  runner.run(5);
+  ReplicationStreams lot(config_charge().seed);
+  for (int i = 0; i < 4; ++i)
+    lot.next();
+  Simulation seule(config_charge(), lot.next());
+  const SimulationReport r = seule.run();
+  assert_test(r.patients_arrived == runner.reports()[4].patients_arrived &&
+                  r.average_wait_to_surgery ==
+                      runner.reports()[4].average_wait_to_surgery,
+              "La replication 4 est reproductible hors du lot");
+}
+
+// --- SCÉNARIO 3b : Noyaux de tirage par lots ---
+void test_tirages_par_lots() {
+  print_header("Tirages par lots : moments empiriques");
+
+  const size_t n = 200001; // impair : la derniere paire est tronquee
+  std::vector<double> valeurs(n);
+  Xoshiro256PlusPlus rng(99);
+
+  RunningStat normale;
+  fill_standard_normal(rng, valeurs.data(), n);
+  for (double v : valeurs)
+    normale.add(v);
+  assert_test(std::abs(normale.mean) < 0.01 &&
+                  std::abs(normale.variance() - 1.0) < 0.02,
+              "Box-Muller : moyenne ~0, variance ~1");
+
+  RunningStat expo;
+  fill_exponential(rng, 0.25, valeurs.data(), n);
+  for (double v : valeurs)
+    expo.add(v);
+  assert_test(std::abs(expo.mean - 4.0) < 0.05 && expo.min > 0.0,
+              "Exponentielle : moyenne 1/taux, valeurs > 0");
+
+  fill_truncated_normal(rng, 3.0, 2.0, 1.0, 3.0, valeurs.data(), n);
+  bool tronquees = true;
+  for (double v : valeurs)
+    tronquees = tronquees && v > 1.0;
+  assert_test(tronquees, "Normale tronquee : toutes les valeurs > borne");
+}
+
+// --- SCÉNARIO 4 : Comparaison en nombres aleatoires communs ---
+void test_comparaison_crn() {
+  print_header("Comparaison CRN de politiques et de ressources");
+
+  const SimulationConfig base = config_charge();
+  std::vector<SimulationConfig> variantes(4, base);
+  variantes[0].policy = SchedulingPolicy::Fifo;
+  variantes[1].policy = SchedulingPolicy::Fifo; // identique a la reference
+  variantes[2].policy = SchedulingPolicy::PriorityFirst;
+  variantes[3].operating_rooms = base.operating_rooms + 1;
+
+  ReplicationRunner runner(base, 4);
+  const ComparisonSummary cmp = runner.compare(variantes, 40);
+  assert_test(cmp.variants.size() == 4 && cmp.differences.size() == 4,
+              "Un agregat et un ecart par variante");
+
+  const RunningStat &nul = cmp.differences[1].metric("average_wait_to_surgery");
+  assert_test(nul.mean == 0.0 && nul.m2 == 0.0,
+              "Variante identique : ecart exactement nul (memes patients)");
+
+  const RunningStat &arrivees = cmp.differences[2].metric("patients_arrived");
+  assert_test(arrivees.mean == 0.0 && arrivees.m2 == 0.0,
+              "Memes arrivees pour toutes les variantes");
+
+  const RunningStat &gain = cmp.differences[3].metric("average_wait_to_surgery");
+  const double ecart_moyennes =
+      cmp.variants[3].metric("average_wait_to_surgery").mean -
+      cmp.variants[0].metric("average_wait_to_surgery").mean;
+  std::cout << " -> Salle supplementaire : " << gain.mean << " +/- "
+            << gain.ci95_half_width() << " min d'attente (IC 95% apparie)\n";
+  assert_test(std::abs(gain.mean - ecart_moyennes) < 1e-9,
+              "Ecart apparie moyen == difference des moyennes");
+  assert_test(gain.mean + gain.ci95_half_width() < 0.0,
+              "Une salle de plus reduit significativement l'attente");
+
+  SimulationConfig autre_flux = base;
+  autre_flux.urgent_rate_per_hour = 4.0;
+  bool refuse = false;
+  try {
+    runner.compare({base, autre_flux}, 2);
+  } catch (const std::invalid_argument &) {
+    refuse = true;
+  }
+  assert_test(refuse, "Une variante qui change le flux est refusee");
+}
+
+int main() {
+  test_flux_aleatoires();
+  test_tirages_par_lots();
+  test_determinisme_threads();
+  test_fusion();
+  test_comparaison_crn();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
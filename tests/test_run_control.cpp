@@ -0,0 +1,144 @@
+#include "core/run_control.h"
+#include "core/simulation.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+// Journee longue : assez d'evenements pour plusieurs points de controle.
+SimulationConfig config_longue() {
+  SimulationConfig config;
+  config.seed = 4242u;
+  config.horizon_hours = 2000.0;
+  config.operating_rooms = 6;
+  config.surgeon_count = 6;
+  config.recovery_beds = 8;
+  config.elective_patients = 5000;
+  config.elective_window_hours = 1900.0;
+  config.urgent_rate_per_hour = 4.0;
+  return config;
+}
+
+bool rapports_identiques(const SimulationReport &a, const SimulationReport &b) {
+  return a.patients_arrived == b.patients_arrived &&
+         a.patients_operated == b.patients_operated &&
+         a.patients_completed == b.patients_completed &&
+         a.average_wait_to_surgery == b.average_wait_to_surgery &&
+         a.max_wait_to_surgery == b.max_wait_to_surgery &&
+         a.operating_room_utilization == b.operating_room_utilization &&
+         a.operations_delayed == b.operations_delayed;
+}
+
+// --- SCÉNARIO 1 : PROGRESSION EN TEMPS SIMULE ---
+void test_progression() {
+  print_header("Progression par paliers de temps simule");
+  const SimulationConfig config = config_longue();
+  Simulation reference(config);
+  const SimulationReport attendu = reference.run();
+
+  Simulation sim(config);
+  RunControl control;
+  std::vector<double> instants;
+  double horizon = 0.0;
+  control.on_progress = [&](double minutes, double total) {
+    instants.push_back(minutes);
+    horizon = total;
+  };
+  sim.set_run_control(&control);
+  const SimulationReport rapport = sim.run();
+
+  bool croissant = true;
+  for (size_t i = 1; i < instants.size(); ++i)
+    croissant = croissant && instants[i] >= instants[i - 1];
+  std::cout << " -> " << instants.size() << " rappels de progression\n";
+  assert_test(rapports_identiques(rapport, attendu),
+              "Resultats identiques avec le controle");
+  assert_test(instants.size() > 10 &&
+                  instants.size() <=
+                      static_cast<size_t>(RunControl::kProgressSteps) + 2,
+              "Rappels bornes par le nombre de paliers");
+  assert_test(croissant, "Temps simule croissant");
+  assert_test(horizon == config.horizon_hours * 60.0, "Horizon transmis");
+  assert_test(instants.back() >= horizon &&
+                  control.simulated_minutes() >= horizon,
+              "Fin de run signalee");
+}
+
+// --- SCÉNARIO 2 : ANNULATION EN COURS DE RUN ---
+void test_annulation_en_cours() {
+  print_header("Annulation cooperative en cours de run");
+  const SimulationConfig config = config_longue();
+  Simulation reference(config);
+  const SimulationReport complet = reference.run();
+
+  Simulation sim(config);
+  RunControl control;
+  const double seuil = config.horizon_hours * 60.0 * 0.3;
+  control.on_progress = [&](double minutes, double) {
+    if (minutes >= seuil)
+      control.request_cancel();
+  };
+  sim.set_run_control(&control);
+  bool annule = false;
+  try {
+    sim.run();
+  } catch (const SimulationCancelled &) {
+    annule = true;
+  }
+  assert_test(annule, "SimulationCancelled levee");
+  assert_test(sim.report().patients_arrived < complet.patients_arrived,
+              "Run interrompu avant la fin");
+
+  // Le moteur reste utilisable : meme resultat qu'un run neuf
+  sim.set_run_control(nullptr);
+  sim.reset(config);
+  assert_test(rapports_identiques(sim.run(), complet),
+              "Run complet apres reset");
+}
+
+// --- SCÉNARIO 3 : ANNULATION DEPUIS UN AUTRE THREAD ---
+void test_annulation_thread() {
+  print_header("Annulation demandee depuis un autre thread");
+  Simulation sim(config_longue());
+  RunControl control;
+  std::thread interface([&control]() { control.request_cancel(); });
+  interface.join();
+  sim.set_run_control(&control);
+  bool annule = false;
+  try {
+    sim.run();
+  } catch (const SimulationCancelled &) {
+    annule = true;
+  }
+  assert_test(annule, "Run abandonne des le depart");
+  assert_test(sim.report().patients_arrived == 0, "Aucun evenement traite");
+}
+
+int main() {
+  test_progression();
+  test_annulation_en_cours();
+  test_annulation_thread();
+
+  std::cout << "\n========================================\n";
+  std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+  std::cout << "========================================\n";
+  return 0;
+}
@@ -0,0 +1,278 @@
+#include "core/replication.h"
+#include "core/report_io.h"
+#include "core/sweep.h"
+#include "core/work_stealing.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- UTILITAIRES ---
+
+void print_header(const std::string &title) {
+  std::cout << "\n========================================\n";
+  std::cout << " TEST : " << title << "\n";
+  std::cout << "========================================\n";
+}
+
+void assert_test(bool condition, const std::string &message) {
+  if (condition) {
+    std::cout << " [OK] " << message << std::endl;
+  } else {
+    std::cout << " [FAIL] " << message << std::endl;
+    std::exit(1);
+  }
+}
+
+bool identiques(const ReplicationSummary &a, const ReplicationSummary &b) {
+  for (size_t i = 0; i < a.metrics.size(); ++i) {
+    const RunningStat &x = a.metrics[i];
+    const RunningStat &y = b.metrics[i];
+    if (x.count != y.count || x.mean != y.mean || x.m2 != y.m2 ||
+        x.min != y.min || x.max != y.max)
+      return false;
+  }
+  return true;
+}
+
+// Puits de test : conserve les points par indice.
+class CollecteurPoints : public SweepSink {
+public:
+  void write_point(const SweepPointResult &result) override {
+    points[result.point] = result;
+  }
+  std::map<size_t, SweepPointResult> points;
+};
+
+SweepDefinition definition_grille() {
+  SweepDefinition def;
+  def.base.horizon_hours = 8.0;
+  def.base.elective_patients = 12;
+  def.base.seed = 77;
+  def.axes.push_back(SweepAxis::range("operating_rooms", 1, 3, 1));
+  def.axes.push_back(SweepAxis{"recovery_beds", {2, 4}});
+  def.axes.push_back(SweepAxis::range("urgent_rate_per_hour", 0.5, 1.5, 0.5));
+  def.replications = 6;
+  return def;
+}
+
+// --- SCÉNARIO 1 : DÉFINITION DE LA GRILLE ---
+void test_grille() {
+  print_header("Definition de la Grille");
+  SweepDefinition def = definition_grille();
+
+  assert_test(def.point_count() == 3 * 2 * 3, "Produit cartesien des axes");
+  const SimulationConfig dernier = def.point_config(def.point_count() - 1);
+  assert_test(dernier.operating_rooms == 3 && dernier.recovery_beds == 4 &&
+                  dernier.urgent_rate_per_hour == 1.5,
+              "Dernier point = dernieres valeurs de chaque axe");
+  const std::vector<double> v = def.point_values(1);
+  assert_test(v[0] == 1 && v[1] == 2 && v[2] == 1.0,
+              "Le dernier axe varie le plus vite");
+
+  def.mode = SweepMode::List;
+  def.axes = {SweepAxis{"operating_rooms", {1, 2}},
+              SweepAxis{"surgeon_count", {2, 3}}};
+  assert_test(def.point_count() == 2 && def.point_config(1).surgeon_count == 3,
+              "Mode liste : un point par rang");
+
+  const SweepAxis plage = SweepAxis::parse("urgent_rate_per_hour=0.5:2:0.5");
+  const SweepAxis liste = SweepAxis::parse("recovery_beds=2,4,8");
+  assert_test(plage.values.size() == 4 && plage.values.back() == 2.0 &&
+                  liste.values.size() == 3 && liste.values[2] == 8.0,
+              "Syntaxe CLI champ=debut:fin:pas et champ=v1,v2");
+
+  bool rejete = false;
+  try {
+    SweepDefinition faux = definition_grille();
+    faux.axes.push_back(SweepAxis{"operating_rooms", {1.5}});
+    faux.validate();
+  } catch (const std::invalid_argument &) {
+    rejete = true;
+  }
+  assert_test(rejete, "Valeur non entiere refusee pour un champ entier");
+}
+
+// --- SCÉNARIO 2 : VOL DE TRAVAIL ---
+void test_vol_de_travail() {
+  print_header("Pool a Vol de Travail");
+  const size_t n = 2000;
+  std::vector<std::atomic<int>> vus(n);
+  for (auto &v : vus)
+    v = 0;
+  // Taches tres inegales : le premier bloc est beaucoup plus long.
+  parallel_for_stealing(n, 4, [&](int, size_t i) {
+    if (i < 50)
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    ++vus[i];
+  });
+  bool exactement_une_fois = true;
+  for (auto &v : vus)
+    exactement_une_fois = exactement_une_fois && v == 1;
+  assert_test(exactement_une_fois, "Chaque indice traite exactement une fois");
+}
+
+// --- SCÉNARIO 3 : DÉTERMINISME ---
+void test_determinisme() {
+  print_header("Balayage Deterministe (1 vs 4 threads)");
+  const SweepDefinition def = definition_grille();
+
+  CollecteurPoints seq;
+  SweepRunner(def, 1).run(seq);
+  CollecteurPoints par;
+  SweepRunner(def, 4).run(par);
+
+  bool memes = seq.points.size() == def.point_count() &&
+               par.points.size() == def.point_count();
+  for (const auto &entry : seq.points)
+    memes = memes && identiques(entry.second.summary,
+                                par.points.at(entry.first).summary);
+  assert_test(memes, "Resultats identiques au bit pres");
+
+  const size_t point = 7;
+  ReplicationRunner reference(def.point_config(point), 2);
+  const ReplicationSummary attendu = reference.run(def.replications);
+  assert_test(identiques(seq.points.at(point).summary, attendu),
+              "Un point = ReplicationRunner sur sa configuration");
+}
+
+// --- SCÉNARIO 4 : SORTIE D'UN LOT ---
+void test_sortie_lot() {
+  print_header("Sortie d'un Lot (runs + agregat)");
+  SimulationConfig config;
+  config.horizon_hours = 6.0;
+  ReplicationRunner runner(config, 2);
+  const ReplicationSummary summary = runner.run(4);
+
+  const auto compter = [](const std::string &texte, const std::string &motif) {
+    size_t n = 0;
+    for (size_t pos = texte.find(motif); pos != std::string::npos;
+         pos = texte.find(motif, pos + 1))
+      ++n;
+    return n;
+  };
+
+  std::ostringstream csv;
+  {
+    BatchWriter writer(csv, OutputFormat::Csv, config.seed);
+    for (int r = 0; r < 4; ++r)
+      writer.write_run(r, runner.reports()[r]);
+    writer.write_summary(summary);
+  }
+  assert_test(compter(csv.str(), "\nrun,") == 4 &&
+                  compter(csv.str(), "\nsummary,4,") == 7,
+              "CSV : 4 lignes run et 7 statistiques d'agregat");
+
+  std::ostringstream jsonl;
+  {
+    BatchWriter writer(jsonl, OutputFormat::JsonLines, config.seed);
+    for (int r = 0; r < 4; ++r)
+      writer.write_run(r, runner.reports()[r]);
+    writer.write_summary(summary);
+  }
+  assert_test(compter(jsonl.str(), "\n") == 5 &&
+                  compter(jsonl.str(), "\"record\":\"summary\"") == 1 &&
+                  compter(jsonl.str(), "\"ci95_low\":") ==
+                      report_metrics().size(),
+              "JSON lines : un objet par run puis l'agregat avec IC");
+}
+
+// --- SCÉNARIO 5 : REPRISE ---
+void test_reprise() {
+  print_header("Reprise d'un Balayage Interrompu");
+  const SweepDefinition def = definition_grille();
+  std::vector<std::string> axes;
+  for (const SweepAxis &axis : def.axes)
+    axes.push_back(axis.field);
+
+  const OutputFormat formats[] = {OutputFormat::Csv, OutputFormat::JsonLines};
+  for (OutputFormat format : formats) {
+    const std::string nom = format == OutputFormat::Csv ? "csv" : "jsonl";
+    const std::string chemin = "test_sweep_reprise." + nom;
+
+    // Sortie complete, puis simulation d'un arret : 5 lignes gardees et une
+    // ligne tronquee.
+    std::ostringstream complet;
+    {
+      SweepWriter writer(complet, format, axes, true, def.fingerprint());
+      SweepRunner(def, 2).run(writer);
+    }
+    std::istringstream lignes(complet.str());
+    std::string ligne;
+    std::ofstream partiel(chemin, std::ios::binary);
+    int gardees = 0;
+    // + empreinte (+ en-tete CSV)
+    const int a_garder = format == OutputFormat::Csv ? 7 : 6;
+    while (gardees < a_garder && std::getline(lignes, ligne)) {
+      partiel << ligne << '\n';
+      ++gardees;
+    }
+    std::getline(lignes, ligne);
+    partiel << ligne.substr(0, ligne.size() / 2);
+    partiel.close();
+
+    // Definition modifiee : reprise refusee, fichier intact
+    SweepDefinition autre = def;
+    autre.replications += 1;
+    const auto taille = std::filesystem::file_size(chemin);
+    bool refuse = false;
+    try {
+      recover_sweep_output(chemin, format, autre.fingerprint());
+    } catch (const std::invalid_argument &) {
+      refuse = true;
+    }
+    assert_test(refuse && std::filesystem::file_size(chemin) == taille &&
+                    autre.fingerprint() != def.fingerprint(),
+                nom + " : autre definition refusee, fichier intact");
+
+    const std::vector<size_t> faits =
+        recover_sweep_output(chemin, format, def.fingerprint());
+    assert_test(faits.size() == 5,
+                nom + " : 5 points relus, ligne tronquee ignoree");
+
+    {
+      std::ofstream suite(chemin, std::ios::app | std::ios::binary);
+      SweepWriter writer(suite, format, axes, false);
+      const size_t calcules = SweepRunner(def, 3).run(writer, faits);
+      assert_test(calcules == def.point_count() - 5,
+                  nom + " : seuls les points manquants sont recalcules");
+    }
+
+    std::vector<size_t> tous = recover_sweep_output(chemin, format);
+    std::vector<int> vus(def.point_count(), 0);
+    for (size_t p : tous)
+      ++vus[p];
+    bool complets = tous.size() == def.point_count();
+    for (int v : vus)
+      complets = complets && v == 1;
+    assert_test(complets, nom + " : chaque point present une seule fois");
+    std::remove(chemin.c_str());
+  }
+}
+
+int main() {
+  try {
+    test_grille();
+    test_vol_de_travail();
+    test_determinisme();
+    test_sortie_lot();
+    test_reprise();
+
+    std::cout << "\n========================================\n";
+    std::cout << " TOUS LES TESTS SONT PASSES AVEC SUCCES \n";
+    std::cout << "========================================\n";
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "Erreur fatale : " << e.what() << std::endl;
+    return 1;
+  }
+}